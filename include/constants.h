@@ -10,21 +10,28 @@
 #ifndef _CONSTANTS_H
 #define _CONSTANTS_H
 
-// Minimum and maximum interval between sending data in milliseconds
+#include <driver/gpio.h>
+
+// Initial minimum interval (adapted to the link quality at runtime) and maximum interval between sending data in milliseconds
 #define SEND_DATA_MIN_INTERVAL 25
 #define SEND_DATA_MAX_INTERVAL 10000
 
-// Period of user inactivity to read the battery voltage in milliseconds (will disable Wi-Fi for a few seconds)
-#define INACTIVITY_PERIOD_FOR_BATTERY_READ 5000
 // Period of inactivity to power off the board in milliseconds
 #define INACTIVITY_PERIOD_FOR_POWER_OFF    10 * 60 * 1000 // 10 minutes
-// Period between battery voltage readings in milliseconds
+// Period between battery voltage readings in milliseconds (the radio is paused for a few milliseconds)
 #define BATTERY_READ_INTERVAL              5 * 60 * 1000 // 5 minutes
 #define BATTERY_LOW_THRESHOLD              3400          // 3.4V
 
 // Number of levers
 #define LEVERS_COUNT 6
 
+// Rate of the lever sampling task in Hz
+#define LEVER_SAMPLING_RATE_HZ 200
+// Period of the lever ADC frames in milliseconds (one frame per sampling cycle)
+#define ADC_FRAME_INTERVAL_MS (1000 / LEVER_SAMPLING_RATE_HZ)
+// Total conversion rate of the continuous ADC driver shared by all lever channels
+#define ADC_SAMPLE_FREQ_HZ 20000
+
 // Number of buttons
 #define BUTTONS_COUNT 3
 
@@ -60,7 +67,7 @@
 #define LEFT_TRAVEL_LEVER  GPIO_NUM_39
 #define RIGHT_TRAVEL_LEVER GPIO_NUM_36
 
-// Battery voltage divider (ADC2 - Wi-Fi must be disabled during readings)
+// Battery voltage divider (ADC2 - shared with the Wi-Fi, see readBatteryVoltage())
 #define BATTERY_VOLTAGE_PIN GPIO_NUM_4
 
 #endif // _CONSTANTS_H
\ No newline at end of file
@@ -43,8 +43,11 @@ typedef struct controller_data_struct
 // The structure type of the data that will be sent over ESP-NOW from the Excavator to the Controller
 typedef struct excavator_data_struct
 {
-    uint16_t uptime;  // Excavator controller uptime
-    uint16_t battery; // Excavator battery voltage
+    uint16_t uptime;         // Excavator controller uptime
+    uint16_t battery;        // Excavator battery voltage
+    uint8_t protocolVersion; // Highest supported wire protocol version (older firmware doesn't send it)
+    uint8_t echoSequence;    // Sequence number of the last v2 frame received from the Controller
+    uint32_t echoHoldUs;     // Time since that frame was received in microseconds (for round-trip time)
 } excavator_data_struct;
 
 #endif // DATA_STRUCTURES_H
\ No newline at end of file
@@ -0,0 +1,314 @@
+/**
+ * @file adc_sampler.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "adc_sampler.h"
+
+#include <Arduino.h>
+#include <esp_idf_version.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#include "constants.h"
+#include "logger.h"
+#include "power_mode.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include <esp_adc/adc_continuous.h>
+#define ADC_USE_CONTINUOUS_DRIVER 1
+#else
+#include <driver/adc.h>
+#include <driver/i2s.h>
+#define ADC_USE_CONTINUOUS_DRIVER 0
+#endif
+
+// Task parameters
+#define ADC_TASK_STACK_SIZE (3 * 1024U)
+#define ADC_TASK_PRIORITY   (tskIDLE_PRIORITY + 3)
+#define ADC_TASK_CORE       1 // Core 0 is used by the WiFi
+
+// Hardware conversions are 12-bit, frames carry 10-bit values as the levers expect
+#define ADC_RAW_TO_FRAME_SHIFT 2
+
+// Size of one DMA chunk - the conversions of all channels within one frame interval
+#define ADC_CONVERSIONS_PER_FRAME (ADC_SAMPLE_FREQ_HZ * ADC_FRAME_INTERVAL_MS / 1000)
+#define ADC_DMA_FRAME_BYTES       (ADC_CONVERSIONS_PER_FRAME * SOC_ADC_DIGI_RESULT_BYTES)
+
+// I2S peripheral moving the conversions of the digital controller to memory before IDF 5 (only I2S0 can)
+#define ADC_I2S_PORT        I2S_NUM_0
+#define ADC_I2S_DMA_BUFFERS 4
+
+// Readings per channel and frame when the DMA can't be started
+#define ADC_BURST_OVERSAMPLING 4
+
+// Accumulates raw conversions of one frame interval
+struct FrameAccumulator
+{
+    uint32_t sums[ADC_FRAME_CHANNELS] = {};
+    uint16_t counts[ADC_FRAME_CHANNELS] = {};
+    AdcFrame frame = {};
+
+    void add(uint8_t channel, uint16_t raw)
+    {
+        if (channel >= ADC_FRAME_CHANNELS)
+            return;
+        sums[channel] += raw;
+        counts[channel]++;
+    }
+
+    /**
+     * @brief Averages the collected conversions into the frame and starts a new interval.
+     *
+     * Channels without conversions in this interval keep their previous value.
+     */
+    const AdcFrame &complete(uint8_t channelMask)
+    {
+        frame.timestampUs = esp_timer_get_time();
+        frame.conversions = UINT16_MAX;
+
+        for (uint8_t channel = 0; channel < ADC_FRAME_CHANNELS; channel++)
+        {
+            if (!(channelMask & (1 << channel)))
+                continue;
+            if (counts[channel])
+                frame.samples[channel] = (sums[channel] / counts[channel]) >> ADC_RAW_TO_FRAME_SHIFT;
+            frame.conversions = min(frame.conversions, counts[channel]);
+            sums[channel] = 0;
+            counts[channel] = 0;
+        }
+
+        return frame;
+    }
+};
+
+bool ContinuousAdcSource::begin(const uint8_t *pins, uint8_t count)
+{
+    channelMask = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int8_t channel = adc1Channel(pins[i]);
+        if (channel < 0)
+        {
+            LOG_ERROR("Pin %u is not an ADC1 pin", pins[i]);
+            return false;
+        }
+        channelMask |= 1 << channel;
+    }
+
+    if (pdPASS != xTaskCreatePinnedToCore(samplingTask,
+                                          "adcTask",
+                                          ADC_TASK_STACK_SIZE,
+                                          this,
+                                          ADC_TASK_PRIORITY,
+                                          NULL,
+                                          ADC_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create adcTask");
+        return false;
+    }
+
+    return true;
+}
+
+bool ContinuousAdcSource::readFrame(AdcFrame &frame)
+{
+    return frames.pop(frame);
+}
+
+uint32_t ContinuousAdcSource::overrunCount() const
+{
+    return frames.overrunCount();
+}
+
+void ContinuousAdcSource::samplingTask(void *pvParameters)
+{
+    static_cast<ContinuousAdcSource *>(pvParameters)->run();
+}
+
+#if ADC_USE_CONTINUOUS_DRIVER
+
+void ContinuousAdcSource::run()
+{
+    static uint8_t buffer[ADC_DMA_FRAME_BYTES];
+    FrameAccumulator accumulator;
+    adc_continuous_handle_t handle = NULL;
+
+    adc_continuous_handle_cfg_t handleConfig = {};
+    handleConfig.max_store_buf_size = ADC_DMA_FRAME_BYTES * 4;
+    handleConfig.conv_frame_size = ADC_DMA_FRAME_BYTES;
+
+    // Sample all lever channels one after another in a single pattern
+    adc_digi_pattern_config_t pattern[ADC_FRAME_CHANNELS] = {};
+    uint8_t patternLength = 0;
+    for (uint8_t channel = 0; channel < ADC_FRAME_CHANNELS; channel++)
+    {
+        if (!(channelMask & (1 << channel)))
+            continue;
+        pattern[patternLength].atten = ADC_ATTEN_DB_11; // 0-3.6V range
+        pattern[patternLength].channel = channel;
+        pattern[patternLength].unit = ADC_UNIT_1;
+        pattern[patternLength].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        patternLength++;
+    }
+
+    adc_continuous_config_t config = {};
+    config.pattern_num = patternLength;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = ADC_SAMPLE_FREQ_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_continuous_new_handle(&handleConfig, &handle) != ESP_OK ||
+        adc_continuous_config(handle, &config) != ESP_OK ||
+        adc_continuous_start(handle) != ESP_OK)
+    {
+        LOG_ERROR("Failed to start continuous ADC");
+        vTaskDelete(NULL);
+    }
+
+    LOG_INFO("adcTask started (continuous mode)");
+
+    for (;;)
+    {
+        uint32_t length = 0;
+
+        // Blocks until the DMA has filled one frame worth of conversions
+        if (adc_continuous_read(handle, buffer, sizeof(buffer), &length, ADC_FRAME_INTERVAL_MS * 2) != ESP_OK)
+            continue;
+
+        for (uint32_t i = 0; i < length; i += SOC_ADC_DIGI_RESULT_BYTES)
+        {
+            adc_digi_output_data_t *result = (adc_digi_output_data_t *)&buffer[i];
+            accumulator.add(result->type1.channel, result->type1.data);
+        }
+
+        frames.push(accumulator.complete(channelMask));
+    }
+}
+
+#else
+
+/**
+ * @brief Starts the conversions of the ADC1 digital controller read by the I2S0 DMA.
+ *
+ * The I2S driver configures the controller for a single channel, so the pattern of all lever
+ * channels is programmed once the I2S ADC mode is enabled.
+ *
+ * @return True if the DMA is running, false if the one-shot conversions have to be used.
+ */
+static bool startI2sAdc(uint8_t channelMask)
+{
+    i2s_config_t i2sConfig = {};
+    i2sConfig.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    i2sConfig.sample_rate = ADC_SAMPLE_FREQ_HZ;
+    i2sConfig.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    i2sConfig.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    i2sConfig.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    i2sConfig.dma_buf_count = ADC_I2S_DMA_BUFFERS;
+    i2sConfig.dma_buf_len = ADC_CONVERSIONS_PER_FRAME;
+
+    // Sample all lever channels one after another in a single pattern
+    adc_digi_pattern_table_t pattern[ADC_FRAME_CHANNELS] = {};
+    uint8_t patternLength = 0;
+    for (uint8_t channel = 0; channel < ADC_FRAME_CHANNELS; channel++)
+    {
+        if (!(channelMask & (1 << channel)))
+            continue;
+        adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11); // 0-3.6V range
+        pattern[patternLength].atten = ADC_ATTEN_DB_11;
+        pattern[patternLength].bit_width = ADC_WIDTH_BIT_12;
+        pattern[patternLength].channel = channel;
+        patternLength++;
+    }
+
+    // Conversion limit as set by the I2S driver for its single channel pattern
+    adc_digi_config_t digiConfig = {};
+    digiConfig.conv_limit_en = true;
+    digiConfig.conv_limit_num = 255;
+    digiConfig.adc1_pattern_len = patternLength;
+    digiConfig.adc1_pattern = pattern;
+    digiConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digiConfig.format = ADC_DIGI_FORMAT_12BIT;
+
+    if (i2s_driver_install(ADC_I2S_PORT, &i2sConfig, 0, NULL) != ESP_OK)
+        return false;
+
+    if (i2s_set_adc_mode(ADC_UNIT_1, (adc1_channel_t)pattern[0].channel) != ESP_OK ||
+        i2s_adc_enable(ADC_I2S_PORT) != ESP_OK)
+    {
+        i2s_driver_uninstall(ADC_I2S_PORT);
+        return false;
+    }
+
+    if (adc_digi_controller_config(&digiConfig) != ESP_OK)
+    {
+        i2s_adc_disable(ADC_I2S_PORT);
+        i2s_driver_uninstall(ADC_I2S_PORT);
+        return false;
+    }
+
+    return true;
+}
+
+void ContinuousAdcSource::run()
+{
+    FrameAccumulator accumulator;
+
+    if (startI2sAdc(channelMask))
+    {
+        static adc_digi_output_data_t buffer[ADC_CONVERSIONS_PER_FRAME];
+
+        LOG_INFO("adcTask started (I2S DMA mode)");
+
+        for (;;)
+        {
+            size_t length = 0;
+
+            // Blocks until the DMA has filled one frame worth of conversions
+            if (i2s_read(ADC_I2S_PORT, buffer, sizeof(buffer), &length, pdMS_TO_TICKS(ADC_FRAME_INTERVAL_MS * 2)) != ESP_OK)
+                continue;
+
+            // Every conversion carries its channel, so the swapped order of the 16-bit words doesn't matter
+            for (size_t i = 0; i < length / sizeof(buffer[0]); i++)
+                accumulator.add(buffer[i].type1.channel, buffer[i].type1.data);
+
+            frames.push(accumulator.complete(channelMask));
+        }
+    }
+
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    for (uint8_t channel = 0; channel < ADC_FRAME_CHANNELS; channel++)
+    {
+        if (channelMask & (1 << channel))
+            adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11); // 0-3.6V range
+    }
+
+    LOG_WARN("adcTask started (burst mode) - failed to start the I2S DMA");
+
+    for (;;)
+    {
+        // Convert all channels back-to-back several times to get a coherent, oversampled frame
+        for (uint8_t n = 0; n < ADC_BURST_OVERSAMPLING; n++)
+        {
+            for (uint8_t channel = 0; channel < ADC_FRAME_CHANNELS; channel++)
+            {
+                if (channelMask & (1 << channel))
+                    accumulator.add(channel, adc1_get_raw((adc1_channel_t)channel));
+            }
+        }
+
+        frames.push(accumulator.complete(channelMask));
+
+        // Convert less often in the idle power mode
+        xTaskDelayUntil(&xLastWakeTime, powerModePeriod(pdMS_TO_TICKS(ADC_FRAME_INTERVAL_MS)));
+    }
+}
+
+#endif // ADC_USE_CONTINUOUS_DRIVER
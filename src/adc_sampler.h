@@ -0,0 +1,102 @@
+/**
+ * @file adc_sampler.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <stdint.h>
+
+#include "spsc_ring.h"
+
+// Number of ADC1 channels, frames are indexed by the channel number
+#define ADC_FRAME_CHANNELS 8
+
+// Number of frames buffered between the sampling task and the consumer
+#define ADC_FRAME_BUFFER_SIZE 16
+
+/**
+ * @brief Returns the ADC1 channel of the GPIO (the index of its samples in the frame).
+ *
+ * Same mapping as digitalPinToAnalogChannel() for the ESP32 ADC1 pins, but usable at compile time.
+ *
+ * @return The channel number or -1 if the pin is not an ADC1 pin.
+ */
+constexpr int8_t adc1Channel(uint8_t pin)
+{
+    // GPIOs of the ADC1 channels 0 to 7
+    constexpr uint8_t channelPins[ADC_FRAME_CHANNELS] = {36, 37, 38, 39, 32, 33, 34, 35};
+
+    for (int8_t channel = 0; channel < ADC_FRAME_CHANNELS; channel++)
+    {
+        if (channelPins[channel] == pin)
+            return channel;
+    }
+    return -1;
+}
+
+// One coherent snapshot of all sampled channels
+struct AdcFrame
+{
+    uint32_t timestampUs;                 // Time when the frame was completed in microseconds
+    uint16_t conversions;                 // Lowest number of conversions averaged into a channel
+    uint16_t samples[ADC_FRAME_CHANNELS]; // Averaged 10-bit values indexed by the ADC1 channel number
+};
+
+/**
+ * @brief Source of ADC frames.
+ *
+ * Consumers only see whole frames, so the hardware driver can be replaced by a synthetic generator.
+ */
+class AdcSource
+{
+public:
+    virtual ~AdcSource() = default;
+
+    /**
+     * @brief Starts sampling of the given analog pins (ADC1 only).
+     * @return True if the sampling has started.
+     */
+    virtual bool begin(const uint8_t *pins, uint8_t count) = 0;
+
+    /**
+     * @brief Takes the oldest unread frame without blocking.
+     * @return True if a frame was read, false if no new frame is available.
+     */
+    virtual bool readFrame(AdcFrame &frame) = 0;
+
+    /**
+     * @brief Returns the number of frames dropped because nobody consumed them in time.
+     */
+    virtual uint32_t overrunCount() const = 0;
+};
+
+/**
+ * @brief Samples all lever channels back-to-back in a background task.
+ *
+ * The ADC1 digital controller converts the channels and the DMA moves the conversions to memory,
+ * through the continuous driver with IDF 5 and the I2S0 ADC mode before. If the DMA can't be
+ * started, oversampled bursts of one-shot conversions are used. Conversions are averaged into
+ * frames published every ADC_FRAME_INTERVAL_MS through a lock-free ring buffer.
+ */
+class ContinuousAdcSource : public AdcSource
+{
+private:
+    SpscRing<AdcFrame, ADC_FRAME_BUFFER_SIZE> frames;
+    uint8_t channelMask = 0; // Bit mask of the sampled ADC1 channels
+
+    static void samplingTask(void *pvParameters);
+    void run();
+
+public:
+    bool begin(const uint8_t *pins, uint8_t count) override;
+    bool readFrame(AdcFrame &frame) override;
+    uint32_t overrunCount() const override;
+};
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,163 @@
+/**
+ * @file battery_curves.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef BATTERY_CURVES_H
+#define BATTERY_CURVES_H
+
+#include <stdint.h>
+#include <array>
+
+// Battery voltage limits for this setup in millivolts (0% and 100% of the state of charge)
+#define MIN_BATT_MV 3200
+#define MAX_BATT_MV 4200
+
+// Voltage step between the state of charge table entries in millivolts (linear interpolation in between)
+#define BATTERY_CURVE_STEP_MV 10
+#define BATTERY_CURVE_SIZE    ((MAX_BATT_MV - MIN_BATT_MV) / BATTERY_CURVE_STEP_MV + 1)
+
+// State of charge of the Li-ion discharge curve every 50 mV from MIN_BATT_MV to MAX_BATT_MV in percent
+#define BATTERY_CURVE_LIION_POINTS {0, 0, 1, 1, 2, 3, 3, 4, 5, 7, 12, 25, 40, 55, 64, 70, 78, 82, 88, 95, 100}
+
+// State of charge of the custom curve, evenly spaced from MIN_BATT_MV to MAX_BATT_MV (piecewise linear in between)
+#ifndef BATTERY_CURVE_CUSTOM_POINTS
+#define BATTERY_CURVE_CUSTOM_POINTS {0, 5, 10, 20, 40, 60, 75, 85, 92, 97, 100}
+#endif
+
+enum BatteryCurve : uint8_t
+{
+    BATTERY_CURVE_LIPO,   // Sigmoid of the LiPo discharge curve (the former pow() formula)
+    BATTERY_CURVE_LIION,  // Typical Li-ion cell, defined by BATTERY_CURVE_LIION_POINTS
+    BATTERY_CURVE_CUSTOM, // Piecewise linear curve defined by BATTERY_CURVE_CUSTOM_POINTS
+};
+
+// Discharge curve of the battery, can be changed with the build flags (e.g. -D BATTERY_CURVE=BATTERY_CURVE_LIION)
+#ifndef BATTERY_CURVE
+#define BATTERY_CURVE BATTERY_CURVE_LIPO
+#endif
+
+using BatteryCurveTable = std::array<uint8_t, BATTERY_CURVE_SIZE>;
+
+/**
+ * @brief Square root by the Newton's method, usable at compile time.
+ */
+constexpr double batteryCurveSqrt(double x)
+{
+    double root = x > 1 ? x : 1;
+    for (uint8_t i = 0; i < 32; i++)
+        root = (root + x / root) / 2;
+    return root;
+}
+
+/**
+ * @brief Interpolates between the points evenly spaced over the voltage range.
+ *
+ * @param points The state of charge points in percent.
+ * @param count The number of the points.
+ * @param offsetMv The voltage above MIN_BATT_MV in millivolts.
+ */
+constexpr uint8_t batteryCurveInterpolate(const uint8_t *points, uint32_t count, uint32_t offsetMv)
+{
+    constexpr uint32_t rangeMv = MAX_BATT_MV - MIN_BATT_MV;
+    uint32_t segments = count - 1;
+    if (offsetMv >= rangeMv)
+        return points[segments];
+
+    uint32_t scaled = offsetMv * segments;
+    uint32_t segment = scaled / rangeMv;
+    uint32_t offset = scaled % rangeMv;
+    return points[segment] + (int32_t)(points[segment + 1] - points[segment]) * (int32_t)offset / (int32_t)rangeMv;
+}
+
+/**
+ * @brief Evaluates the discharge curve for a single voltage.
+ *
+ * @param curve The discharge curve type.
+ * @param voltage The battery voltage in the range of MIN_BATT_MV to MAX_BATT_MV.
+ * @return The state of charge in percent.
+ *
+ * @note The LiPo sigmoid is inspired by this repository: https://github.com/rlogiacco/BatterySense
+ */
+constexpr uint8_t batteryCurvePoint(BatteryCurve curve, uint32_t voltage)
+{
+    switch (curve)
+    {
+        case BATTERY_CURVE_LIION:
+        {
+            constexpr uint8_t points[] = BATTERY_CURVE_LIION_POINTS;
+            return batteryCurveInterpolate(points, sizeof(points), voltage - MIN_BATT_MV);
+        }
+        case BATTERY_CURVE_CUSTOM:
+        {
+            constexpr uint8_t points[] = BATTERY_CURVE_CUSTOM_POINTS;
+            return batteryCurveInterpolate(points, sizeof(points), voltage - MIN_BATT_MV);
+        }
+        default:
+        {
+            // 105 - 105 / (1 + (1.724 * x)^5.5), the power is split into x^5 * sqrt(x)
+            if (voltage >= MAX_BATT_MV)
+                return 100;
+            double x = 1.724 * (voltage - MIN_BATT_MV) / (MAX_BATT_MV - MIN_BATT_MV);
+            double power = x * x * x * x * x * batteryCurveSqrt(x);
+            uint8_t result = 105 - (105 / (1 + power));
+            return result >= 100 ? 100 : result;
+        }
+    }
+}
+
+/**
+ * @brief Generates the state of charge table at compile time.
+ */
+constexpr BatteryCurveTable makeBatteryCurveTable(BatteryCurve curve)
+{
+    BatteryCurveTable table{};
+    for (uint32_t i = 0; i < BATTERY_CURVE_SIZE; i++)
+        table[i] = batteryCurvePoint(curve, MIN_BATT_MV + i * BATTERY_CURVE_STEP_MV);
+    return table;
+}
+
+/**
+ * @brief Checks that the state of charge never drops with a rising voltage.
+ */
+constexpr bool isBatteryCurveMonotonic(const BatteryCurveTable &table)
+{
+    for (uint32_t i = 1; i < BATTERY_CURVE_SIZE; i++)
+        if (table[i] < table[i - 1])
+            return false;
+    return true;
+}
+
+// State of charge table of the selected curve generated by the compiler and stored in flash
+inline constexpr BatteryCurveTable batteryCurveTable = makeBatteryCurveTable(BATTERY_CURVE);
+
+static_assert((MAX_BATT_MV - MIN_BATT_MV) % BATTERY_CURVE_STEP_MV == 0, "Voltage range must be a multiple of the step");
+static_assert(batteryCurveTable[0] == 0, "Battery curve must start at 0%");
+static_assert(batteryCurveTable[BATTERY_CURVE_SIZE - 1] == 100, "Battery curve must reach 100%");
+static_assert(isBatteryCurveMonotonic(batteryCurveTable), "Battery curve must be monotonic");
+
+/**
+ * @brief Converts the battery voltage into the state of charge using integer math only.
+ *
+ * @param voltage The battery voltage in millivolts.
+ * @return The state of charge in percent.
+ */
+inline uint8_t batteryCurveLevel(uint16_t voltage)
+{
+    if (voltage <= MIN_BATT_MV)
+        return 0;
+    if (voltage >= MAX_BATT_MV)
+        return 100;
+
+    // Interpolate between the neighbouring table entries
+    uint32_t offset = voltage - MIN_BATT_MV;
+    uint32_t index = offset / BATTERY_CURVE_STEP_MV;
+    uint32_t remainder = offset % BATTERY_CURVE_STEP_MV;
+    return batteryCurveTable[index] + (batteryCurveTable[index + 1] - batteryCurveTable[index]) * remainder / BATTERY_CURVE_STEP_MV;
+}
+
+#endif // BATTERY_CURVES_H
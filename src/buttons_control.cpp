@@ -9,6 +9,7 @@
 
 #include "buttons_control.h"
 #include "constants.h"
+#include "logger.h"
 
 // Define buttons
 Button powerBtn(POWER_BUTTON, INPUT_PULLUP);
@@ -26,7 +27,7 @@ void defaultButtonCallback(const char *buttonName, Button &button)
     // Log only click events
     if (button.action() == EB_CLICK)
     {
-        Serial.printf("Button %s clicked\n", buttonName);
+        LOG_INFO("Button %s clicked", buttonName);
     }
 }
 
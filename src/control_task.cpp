@@ -0,0 +1,274 @@
+/**
+ * @file control_task.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "control_task.h"
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#include "buttons_control.h"
+#include "constants.h"
+#include "data_structures.h"
+#include "display.h"
+#include "esp_now_interface.h"
+#include "fast_boot.h"
+#include "housekeeping_task.h"
+#include "link_rate.h"
+#include "logger.h"
+#include "power_manager.h"
+#include "power_mode.h"
+#include "profiler.h"
+#include "rtt_stats.h"
+#include "sampling_task.h"
+#include "seqlock.h"
+#include "telemetry.h"
+#include "wire_format.h"
+
+// Task parameters
+#define CONTROL_TASK_STACK_SIZE (4 * 1024U)
+#define CONTROL_TASK_PRIORITY   (tskIDLE_PRIORITY + 3)
+#define CONTROL_TASK_CORE       1 // Core 0 is used by the WiFi
+
+// Global variables
+extern controller_data_struct dataToSend;
+extern volatile uint32_t lastUserActivityTime;
+
+// Flags and variables
+uint32_t lastSendDataTime = 0;
+uint32_t packetsSent = 0, lastStatsTime = 0, lastStatsPackets = 0;
+volatile bool anyButtonPressed = false;
+
+ControlStats controlStats;
+SeqLock<ControlStats> publishedControlStats;
+
+// Callback function to handle power button press
+void powerButtonCallback()
+{
+    // Update the last user activity time
+    lastUserActivityTime = millis();
+    powerModeWake();
+
+    if (powerBtn.action() == EB_CLICK)
+    {
+        LOG_INFO("Power button clicked - Turning off the board...");
+        requestPowerOff();
+    }
+}
+
+/**
+ * @brief Processes the button action and updates the button state.
+ *
+ * This function is called when a button is clicked. It updates the state of the button
+ * and sets a flag indicating that a button has been pressed. It also updates the last user
+ * activity time.
+ *
+ * @param buttonIndex The index of the button.
+ * @param button The Button object representing the clicked button.
+ */
+void processButton(uint8_t buttonIndex, Button &button, const char *buttonName)
+{
+    if (button.action() == EB_CLICK)
+    {
+        dataToSend.buttonsStates[buttonIndex] = !dataToSend.buttonsStates[buttonIndex];
+        LOG_INFO("Button %s clicked", buttonName);
+        anyButtonPressed = true;
+        lastUserActivityTime = millis();
+        powerModeWake();
+    }
+}
+
+/**
+ * @brief Prints the statistics of all pipeline stages.
+ */
+void printPipelineStats()
+{
+    SamplingStats stats = getSamplingStats();
+    LOG_INFO("Sampling: %u cycles | Period: %u us | Jitter avg: %u us, max: %u us | "
+             "Process max: %u us | Overruns: %u",
+             stats.cycles, stats.avgPeriodUs, stats.avgJitterUs, stats.maxJitterUs,
+             stats.maxProcessUs, stats.overruns);
+
+    uint32_t elapsed = max<uint32_t>(lastSendDataTime - lastStatsTime, 1);
+    LOG_INFO("Lever updates emitted: %u, suppressed: %u | Packets: %u (%u.%02u/s)",
+             stats.emitted, stats.suppressed, packetsSent,
+             (packetsSent - lastStatsPackets) * 1000 / elapsed,
+             (packetsSent - lastStatsPackets) * 100000 / elapsed % 100);
+    RttStats rtt = getRttStats();
+    LOG_INFO("RTT: %u samples | min: %u us | avg: %u us | p99: %u us | max: %u us",
+             rtt.count, rtt.minUs, rtt.avgUs, rtt.p99Us, rtt.maxUs);
+    RadioStats radio = getRadioStats();
+    LOG_INFO("Radio: %u posted, %u sent, %u coalesced | Busy retries: %u | Errors: %u, timeouts: %u, late: %u",
+             radio.framesPosted, radio.framesSent, radio.framesCoalesced, radio.busyRetries,
+             radio.sendErrors, radio.sendTimeouts, radio.staleCompletions);
+    LinkRateState link = getLinkRateState();
+    LOG_INFO("Link: interval %u ms | Success: %u.%u%% | MAC latency: %u us | "
+             "Delivered: %u, failed: %u | Speed-ups: %u, back-offs: %u",
+             link.intervalMs, link.successPermille / 10, link.successPermille % 10,
+             link.avgLatencyUs, link.delivered, link.failed, link.speedUps, link.backOffs);
+    BatteryStats battery = getBatteryStats();
+    BatteryEstimate estimate = getBatteryEstimate();
+    LOG_INFO("Battery: %u%%, %u min left | %u measurements, %u with radio stop, %u deferred, %u failed | "
+             "Link paused: last %u us, max %u us | WiFi rejoin: last %u us, max %u us",
+             estimate.socPercent, estimate.minutesRemaining, battery.measurements, battery.radioStops,
+             battery.deferrals, battery.failures, battery.lastBlindUs, battery.maxBlindUs, battery.lastRejoinUs,
+             battery.maxRejoinUs);
+    PowerModeStats power = getPowerModeStats();
+    LOG_INFO("Power: %s | Idle: %u of %u s, %u entries | Wake->send: last %u us, max %u us, late: %u",
+             getPowerMode() == POWER_MODE_IDLE ? "idle" : "active", power.idleMs / 1000,
+             (power.idleMs + power.activeMs) / 1000, power.idleEntries, power.lastWakeToSendUs,
+             power.maxWakeToSendUs, power.lateWakeups);
+    BootStats boot = getBootStats();
+    LOG_INFO("Boot: %s | First frame: %u us, previous boot: %u us | Fast boots: %u",
+             boot.fastBoot ? "fast" : "cold", boot.firstFrameUs, boot.previousFirstFrameUs, boot.fastBoots);
+    DisplayStats display = getDisplayStats();
+    LOG_INFO("Display: %u frames, %u unchanged | %u pages, %u bytes sent | %u B/s | Render avg: %u us, max: %u us",
+             display.frames, display.skippedFrames, display.pagesSent, display.bytesSent, display.bytesPerSecond,
+             display.avgRenderUs, display.maxRenderUs);
+    LOG_INFO("Display: %u wakeups, %u by watchdog, %u saved | Bus frame last: %u us, max: %u us | "
+             "Errors: %u, queue waits: %u",
+             display.wakeups, display.watchdogRefreshes, display.savedWakeups, display.bus.lastFrameUs,
+             display.bus.maxFrameUs, display.bus.errors, display.bus.queueWaits);
+    TelemetryStats telemetry = getTelemetryStats();
+    LOG_INFO("Telemetry: %u received, %u processed | Invalid: %u | Overruns: %u",
+             telemetry.received, telemetry.processed, telemetry.invalid, telemetry.overruns);
+
+    // Latency of every stage from the ADC frame to the completed transmission (avg/max)
+    ControlStats control = getControlStats();
+    LOG_INFO("Latency [us]: sample->publish %u/%u | sample->post %u/%u | post->send %u/%u | "
+             "sample->send %u/%u | post->done max %u",
+             stats.avgPublishLatencyUs, stats.maxPublishLatencyUs,
+             control.avgSampleToPostUs, control.maxSampleToPostUs,
+             radio.avgPostToSendUs, radio.maxPostToSendUs,
+             radio.avgSampleToSendUs, radio.maxSampleToSendUs, radio.maxPostToDoneUs);
+
+    lastStatsTime = lastSendDataTime;
+    lastStatsPackets = packetsSent;
+}
+
+/**
+ * Checks if it is time to send data to the Excavator and sends the data if necessary.
+ *
+ * The function checks if any lever has moved or any button has been pressed. If so, it sends the data
+ * to the Excavator at the interval adapted to the link quality (see link_rate.h). If no lever has moved or button has been
+ * pressed, it sends the data every SEND_DATA_MAX_INTERVAL milliseconds.
+ */
+void checkAndSendData()
+{
+    PROFILE_SCOPE(PROFILE_CHECK_AND_SEND);
+
+    bool timeToSendData = (anyLeverMoved || anyButtonPressed) && millis() - lastSendDataTime > getSendInterval();
+    bool timeToPingExcavator = millis() - lastSendDataTime > SEND_DATA_MAX_INTERVAL;
+    if (timeToSendData || timeToPingExcavator)
+    {
+        // Reset the flags before taking the snapshot, so a change after it is not lost
+        anyLeverMoved = false;
+        anyButtonPressed = false;
+
+        const ControllerSnapshot snapshot = readControllerSnapshot();
+        const controller_data_struct &data = snapshot.data;
+        sendDataToExcavator(data, timeToSendData ? 0 : WIRE_FLAG_KEEPALIVE, snapshot.timestampUs);
+        if (timeToSendData)
+            powerModeFrameSent();
+
+        // Measure the time from the ADC frame to posting the data
+        if (snapshot.timestampUs)
+        {
+            uint32_t latencyUs = (uint32_t)esp_timer_get_time() - snapshot.timestampUs;
+            controlStats.avgSampleToPostUs += ((int32_t)latencyUs - (int32_t)controlStats.avgSampleToPostUs) / 16;
+            controlStats.maxSampleToPostUs = max(controlStats.maxSampleToPostUs, latencyUs);
+        }
+        controlStats.posted++;
+        publishedControlStats.write(controlStats);
+
+        // Update the last send data time
+        lastSendDataTime = millis();
+        packetsSent++;
+
+        // Print all lever positions if any lever has moved (compiled out below LOG_LEVEL_DEBUG)
+        LOG_DEBUG("Boom: %3d | Bucket: %3d | Stick: %3d | Swing: %3d | "
+                  "Track Left: %3d | Track Right: %3d | Lights: %d | Center Swing: %d | Battery: %3d",
+                  data.leverPositions[0], data.leverPositions[1], data.leverPositions[2],
+                  data.leverPositions[3], data.leverPositions[4], data.leverPositions[5],
+                  data.buttonsStates[0], data.buttonsStates[1], data.battery);
+
+        // Print the statistics of all stages with every ping
+        if (timeToPingExcavator)
+            printPipelineStats();
+    }
+}
+
+/**
+ * @brief Task handling the buttons and posting the controller data to the radio task.
+ *
+ * Runs at the lever sampling rate right after the sampling task, which has a higher priority on the same core.
+ * Both run every POWER_IDLE_PERIOD_MS in the idle power mode.
+ *
+ * @param pvParameters A pointer to task parameters (not used in this function).
+ */
+void controlTask(void *pvParameters)
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    for (;;)
+    {
+        {
+            PROFILE_SCOPE(PROFILE_CONTROL_CYCLE);
+
+            // Handle buttons
+            {
+                PROFILE_SCOPE(PROFILE_TICK_BUTTONS);
+                tickButtons();
+            }
+
+            // Send data to the Excavator if necessary
+            checkAndSendData();
+        }
+
+        // Poll the buttons less often in the idle power mode
+        xTaskDelayUntil(&xLastWakeTime, powerModePeriod(pdMS_TO_TICKS(1000 / LEVER_SAMPLING_RATE_HZ)));
+    }
+}
+
+/**
+ * @brief Attaches the button callbacks and initializes the control task.
+ *
+ * @note This function should be called once during the setup phase of the program.
+ */
+void controlTaskInit(void)
+{
+    // Init buttons
+    initButtons();
+    powerBtn.attach(powerButtonCallback);
+    mainLightsBtn.attach([=]()
+                         { processButton(0, mainLightsBtn, "Lights"); });
+    centerSwingBtn.attach([=]()
+                          { processButton(1, centerSwingBtn, "Center Swing"); });
+    beaconLightModeBtn.attach([=]()
+                              { processButton(2, beaconLightModeBtn, "Beacon Light Mode"); });
+
+    if (pdPASS != xTaskCreatePinnedToCore(controlTask,
+                                          "controlTask",
+                                          CONTROL_TASK_STACK_SIZE,
+                                          NULL,
+                                          CONTROL_TASK_PRIORITY,
+                                          NULL,
+                                          CONTROL_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create controlTask");
+    }
+}
+
+/**
+ * @brief Returns a consistent copy of the control stage statistics.
+ */
+ControlStats getControlStats(void)
+{
+    return publishedControlStats.read();
+}
@@ -0,0 +1,26 @@
+/**
+ * @file control_task.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef CONTROL_TASK_H
+#define CONTROL_TASK_H
+
+#include <stdint.h>
+
+// Latency statistics of the control stage
+struct ControlStats
+{
+    uint32_t posted;            // Frames posted to the radio task
+    uint32_t avgSampleToPostUs; // Average time from the ADC frame to posting the data in microseconds
+    uint32_t maxSampleToPostUs; // Maximum time from the ADC frame to posting the data in microseconds
+};
+
+void controlTaskInit(void);
+ControlStats getControlStats(void);
+
+#endif // CONTROL_TASK_H
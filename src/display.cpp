@@ -11,40 +11,68 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 
 #include <data_structures.h>
 #include "display.h"
+#include "display_i2c_bus.h"
+#include "display_panel.h"
+#include "display_screens.h"
+#include "logger.h"
 #include "power_manager.h"
+#include "rtt_stats.h"
+#include "sampling_task.h"
+#include "seqlock.h"
+#include "telemetry.h"
 
 // Task parameters
 #define DISPLAY_TASK_STACK_SIZE (4 * 1024U)
 #define DISPLAY_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
 #define DISPLAY_TASK_CORE       1 // Core 0 is used by the WiFi
 
-// Display dimensions
-#define SCREEN_WIDTH  128
-#define SCREEN_HEIGHT 64
-
 // Display addresses
 #define LEFT_SCREEN_ADDRESS  0x3C
 #define RIGHT_SCREEN_ADDRESS 0x3D
 
+// Refresh limits: events arriving faster than DISPLAY_MAX_FPS are merged into one frame, without any events
+// the screen is refreshed at least every DISPLAY_MIN_REFRESH_MS (the uptime is refreshed every second anyway)
+#ifndef DISPLAY_MAX_FPS
+#define DISPLAY_MAX_FPS 10
+#endif
+#define DISPLAY_MIN_REFRESH_MS  1000
+#define DISPLAY_BLINK_PERIOD_MS 500
+
+// Period of the former fixed polling, used to count the saved wakeups
+#define DISPLAY_POLL_PERIOD_MS 100
+
 // BLink with the battery icon if the battery level is lower than this threshold
 #define BATTERY_NOTIFICATION_THRESHOLD 20
 
 // Global variables
-extern controller_data_struct dataToSend;
-extern excavator_data_struct receivedData;
-
 DisplayState currentState = DISPLAY_DEFAULT;
 
 // Semaphore to signal display disabled
 SemaphoreHandle_t displayDisabledSemaphore;
 
-// Declaration for an SSD1306 display connected to I2C (SDA, SCL pins)
-Adafruit_SSD1306 leftDisplay(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire);
-Adafruit_SSD1306 rightDisplay(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire);
+TaskHandle_t displayTaskHandle = NULL;
+
+// Declaration for an SSD1306 display connected to I2C (SDA, SCL pins), the library keeps the fast clock too
+Adafruit_SSD1306 leftDisplay(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1, DISPLAY_I2C_CLOCK_HZ, DISPLAY_I2C_CLOCK_HZ);
+Adafruit_SSD1306 rightDisplay(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1, DISPLAY_I2C_CLOCK_HZ, DISPLAY_I2C_CLOCK_HZ);
+
+// Send only the changes of the rendered frames, queued for the bus task
+static I2cDisplayBus displayBus;
+static DisplayPanel leftPanel(leftDisplay, displayBus, LEFT_SCREEN_ADDRESS);
+static DisplayPanel rightPanel(rightDisplay, displayBus, RIGHT_SCREEN_ADDRESS);
+
+// Refresh statistics, updated only from the display task
+static DisplayStats stats;
+static uint64_t totalRenderUs = 0;
+static SeqLock<DisplayStats> publishedStats;
+static uint32_t rateWindowStartMs = 0;
+static uint32_t rateWindowBytes = 0;
+static uint32_t taskStartMs = 0;
 
 volatile uint16_t otaProgress;
 
@@ -56,7 +84,19 @@ volatile uint16_t otaProgress;
 void setDisplayState(DisplayState state)
 {
     currentState = state;
-    Serial.println("Display state changed to " + String(state));
+    notifyDisplay(DISPLAY_EVENT_STATE);
+    LOG_INFO("Display state changed to %d", state);
+}
+
+/**
+ * @brief Wakes the display task up to show changed data.
+ *
+ * @param events DISPLAY_EVENT_* bits describing what has changed.
+ */
+void notifyDisplay(uint32_t events)
+{
+    if (displayTaskHandle)
+        xTaskNotify(displayTaskHandle, events, eSetBits);
 }
 
 /**
@@ -66,51 +106,102 @@ void setDisplayState(DisplayState state)
  */
 void disableDisplay(bool blocking)
 {
-    Serial.println("Disabling display...");
+    LOG_INFO("Disabling display...");
     currentState = DISPLAY_OFF;
+    notifyDisplay(DISPLAY_EVENT_STATE);
 
     if (blocking)
     {
         // Wait for the semaphore to be given by the display task
         if (xSemaphoreTake(displayDisabledSemaphore, portMAX_DELAY) != pdTRUE)
         {
-            Serial.println("ERROR: failed to disable display");
+            LOG_ERROR("Failed to disable display");
         }
-        Serial.println("Display disabled");
+        LOG_INFO("Display disabled");
     }
 }
 
 /**
- * @brief Power off the display (the lowest power consumption).
+ * @brief Initializes the display.
  *
- * @param display The display object to power off.
+ * @param panel The display to initialize, the task is deleted if it fails.
  */
-void displayOff(Adafruit_SSD1306 &display)
+void setupDisplay(DisplayPanel &panel)
 {
-    display.clearDisplay();
-    display.display();
-    display.ssd1306_command(SSD1306_DISPLAYOFF);
+    if (!panel.begin())
+    {
+        LOG_ERROR("SSD1306 allocation failed");
+        vTaskDelete(NULL);
+    }
 }
 
 /**
- * @brief Initializes the display.
+ * @brief Queues the changes of the rendered frames for both displays and updates the statistics.
  *
- * This function sets up the display by initializing the Adafruit_SSD1306 object and configuring its properties.
- * It takes an Adafruit_SSD1306 object and the address of the display as parameters.
+ * The pages of the displays are interleaved, so both of them are updated at the same pace.
  *
- * @param display The Adafruit_SSD1306 object representing the display.
- * @param address The I2C address of the display.
+ * @param frameStartUs Time the rendering of the frames started in microseconds.
  */
-void setupDisplay(Adafruit_SSD1306 &display, uint8_t address)
+void flushDisplays(uint32_t frameStartUs)
 {
-    // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
-    if (!display.begin(SSD1306_SWITCHCAPVCC, address))
+    uint8_t pages = 0;
+    uint32_t bytes = 0;
+
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++)
     {
-        Serial.println(F("ERROR: SSD1306 allocation failed"));
-        vTaskDelete(NULL);
+        PanelFlushResult left = leftPanel.flushPage(page);
+        PanelFlushResult right = rightPanel.flushPage(page);
+        pages += left.pages + right.pages;
+        bytes += left.bytes + right.bytes;
+    }
+
+    stats.frames++;
+    if (!pages)
+        stats.skippedFrames++;
+    stats.pagesSent += pages;
+    stats.bytesSent += bytes;
+
+    // The transfers continue in the background, so this is the time the display task was busy
+    uint32_t renderUs = (uint32_t)esp_timer_get_time() - frameStartUs;
+    totalRenderUs += renderUs;
+    stats.avgRenderUs = totalRenderUs / stats.frames;
+    stats.maxRenderUs = renderUs > stats.maxRenderUs ? renderUs : stats.maxRenderUs;
+
+    uint32_t now = millis();
+    if (now - rateWindowStartMs >= 1000)
+    {
+        stats.bytesPerSecond = (uint64_t)(stats.bytesSent - rateWindowBytes) * 1000 / (now - rateWindowStartMs);
+        rateWindowStartMs = now;
+        rateWindowBytes = stats.bytesSent;
     }
-    display.setTextColor(SSD1306_WHITE);
-    display.setTextSize(1);
+}
+
+/**
+ * @brief Counts a wakeup of the display task and publishes the statistics.
+ *
+ * @param watchdog True if the task was woken up by the minimum refresh timeout instead of an event.
+ */
+void countWakeup(bool watchdog)
+{
+    stats.wakeups++;
+    if (watchdog)
+        stats.watchdogRefreshes++;
+
+    // The fixed polling would have woken the task up every DISPLAY_POLL_PERIOD_MS
+    uint32_t pollWakeups = (millis() - taskStartMs) / DISPLAY_POLL_PERIOD_MS;
+    stats.savedWakeups = pollWakeups > stats.wakeups ? pollWakeups - stats.wakeups : 0;
+
+    publishedStats.write(stats);
+}
+
+/**
+ * @brief Returns a consistent copy of the display refresh statistics.
+ */
+DisplayStats getDisplayStats(void)
+{
+    DisplayStats copy = publishedStats.read();
+    copy.bus = displayBus.getStats();
+    return copy;
 }
 
 /**
@@ -123,152 +214,112 @@ void setupDisplay(Adafruit_SSD1306 &display, uint8_t address)
  */
 void setOTAProgress(uint16_t percentage)
 {
+    if (percentage == otaProgress)
+        return;
+
     otaProgress = percentage;
+    notifyDisplay(DISPLAY_EVENT_OTA);
 }
 
-void printTitle(Adafruit_SSD1306 &display, const char *title, uint16_t batteryVoltage, uint16_t uptimeSec)
+/**
+ * @brief Prerenders the static parts of the screen into the backgrounds of both displays.
+ *
+ * @param state The display state whose screen is prerendered.
+ */
+void renderBackgrounds(DisplayState state)
 {
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setCursor(0, 0);
-    display.println(title);
-
-    // Calculate the battery level percentage (assuming 3.4V to 4.2V range)
-    uint8_t batteryLevel = calculateBatteryLevel(batteryVoltage);
-
-    // Draw the battery icon
-    int batteryIconWidth = 16;
-    int batteryIconHeight = 8;
-    int batteryPoleWidth = 2;
-    int batteryPoleHeight = 4;
-    int batteryIconX = display.width() - batteryIconWidth - batteryPoleWidth;
-    int batteryIconY = 0;
-
-    // Draw the battery outline
-    display.drawRect(batteryIconX, batteryIconY, batteryIconWidth, batteryIconHeight, SSD1306_WHITE);
-
-    // Draw the battery pole
-    display.fillRect(batteryIconX + batteryIconWidth, batteryIconHeight / 2 - batteryPoleHeight / 2,
-                     batteryPoleWidth, batteryPoleHeight, SSD1306_WHITE);
-
-    // Draw the battery level
-    int batteryLevelWidth = (batteryIconWidth - 2) * (batteryLevel / 100.0);
-    display.fillRect(batteryIconX + 1, batteryIconY + 1, batteryLevelWidth, batteryIconHeight - 2, SSD1306_WHITE);
-
-    // Print the battery percentage with right-alignment
-    String batteryPercentageText = String(batteryLevel) + "%";
-    int16_t x1, y1;
-    uint16_t textWidth, textHeight;
-    display.getTextBounds(batteryPercentageText, 0, 0, &x1, &y1, &textWidth, &textHeight);
-    display.setCursor(batteryIconX - textWidth - 3, batteryIconY);
-    display.print(batteryPercentageText);
-
-    // Draw the uptime on the next line
-    display.setCursor(0, 8);
-    display.print("Uptime: ");
-    display.print(uptimeSec);
-
-    display.setCursor(0, 56);
-    display.print("Battery: ");
-    display.print(batteryVoltage / 1000.0, 3); // Print voltage in Volts
-    display.print("V");
-
-    display.display();
+    leftDisplay.clearDisplay();
+    rightDisplay.clearDisplay();
+
+    switch (state)
+    {
+        case DISPLAY_DEFAULT:
+            drawTitleBackground(leftDisplay, "CONTROLLER");
+            drawTitleBackground(rightDisplay, "EXCAVATOR");
+            break;
+        case DISPLAY_LOW_POWER:
+            printAt(leftDisplay, 0, 0, 2, LOW_POWER_LABEL);
+            printAt(rightDisplay, 0, 0, 2, LOW_POWER_LABEL);
+            break;
+        case DISPLAY_OTA_UPDATE:
+            drawOtaBackground(leftDisplay, "OTA UPDATE");
+            drawOtaBackground(rightDisplay, "IN PROCESS");
+            break;
+        default:
+            break;
+    }
+
+    leftPanel.saveBackground();
+    rightPanel.saveBackground();
 }
 
 // ############################## Screens ##############################
 void displayDefault()
 {
-    printTitle(leftDisplay, "CONTROLLER", dataToSend.battery, millis() / 1000);
-    printTitle(rightDisplay, "EXCAVATOR", receivedData.battery, receivedData.uptime);
-}
+    leftPanel.restoreBackground();
+    rightPanel.restoreBackground();
 
-void displayLowPower()
-{
-    static bool blinkState = true;
+    printTitleValues(leftDisplay, readControllerSnapshot().data.battery, millis() / 1000);
+    const excavator_data_struct excavator = readTelemetrySnapshot().data;
+    printTitleValues(rightDisplay, excavator.battery, excavator.uptime);
 
-    // Blink the low power message
-    leftDisplay.clearDisplay();
-    leftDisplay.setTextSize(2);
-    leftDisplay.setCursor(0, 0);
-    leftDisplay.print("BAT: ");
-    leftDisplay.print(dataToSend.battery / 1000.0, 2); // Print voltage in Volts
-    leftDisplay.print("V");
-    if (blinkState)
+    // Print the measured round-trip time of the link
+    RttStats rtt = getRttStats();
+    if (rtt.count)
     {
-        leftDisplay.setCursor(38, 20);
-        leftDisplay.setTextSize(3);
-        leftDisplay.print("LOW");
+        char text[32];
+        snprintf(text, sizeof(text), "RTT: %u.%u/%u.%u ms", rtt.avgUs / 1000, rtt.avgUs / 100 % 10, rtt.p99Us / 1000, rtt.p99Us / 100 % 10);
+        printAt(rightDisplay, 0, 16, 1, text);
     }
+}
 
-    rightDisplay.clearDisplay();
-    rightDisplay.setTextSize(2);
-    rightDisplay.setCursor(0, 0);
-    rightDisplay.print("BAT: ");
-    rightDisplay.print(dataToSend.battery / 1000.0, 2); // Print voltage in Volts
-    rightDisplay.print("V");
-    if (blinkState)
-    {
-        rightDisplay.setCursor(20, 20);
-        rightDisplay.setTextSize(3);
-        rightDisplay.print("POWER");
-    }
+void displayLowPower()
+{
+    // Derived from the time, so refreshes caused by the events don't change the blink rate
+    bool blinkState = millis() / DISPLAY_BLINK_PERIOD_MS % 2 == 0;
+    uint16_t battery = readControllerSnapshot().data.battery;
 
-    leftDisplay.display();
-    rightDisplay.display();
+    leftPanel.restoreBackground();
+    rightPanel.restoreBackground();
 
-    // Toggle the blink state
-    blinkState = !blinkState;
+    // Blink the low power message
+    printLowPowerValues(leftDisplay, battery, blinkState ? "LOW" : nullptr, 38);
+    printLowPowerValues(rightDisplay, battery, blinkState ? "POWER" : nullptr, 20);
 }
 
 void displayOtaUpdate()
 {
-    // Clear the displays
-    leftDisplay.clearDisplay();
-    rightDisplay.clearDisplay();
-
-    // Print OTA update message
-    leftDisplay.setTextSize(2);
-    leftDisplay.setCursor(5, 0);
-    leftDisplay.print("OTA UPDATE");
-
-    rightDisplay.setTextSize(2);
-    rightDisplay.setCursor(5, 0);
-    rightDisplay.print("IN PROCESS");
-
-    // Draw progress bar
-    uint16_t barWidth = 100;
-    uint16_t barHeight = 10;
-    uint16_t barX = (leftDisplay.width() - barWidth) / 2;
-    uint16_t barY = (leftDisplay.height() - barHeight) / 2;
-
-    // Calculate the fill width based on the progress percentage
-    uint16_t barFillWidth = (barWidth - 2) * ((float)otaProgress / 100);
+    leftPanel.restoreBackground();
+    rightPanel.restoreBackground();
 
-    leftDisplay.drawRect(barX, barY, barWidth, barHeight, SSD1306_WHITE);
-    leftDisplay.fillRect(barX + 1, barY + 1, barFillWidth, barHeight - 2, SSD1306_WHITE);
-
-    rightDisplay.drawRect(barX, barY, barWidth, barHeight, SSD1306_WHITE);
-    rightDisplay.fillRect(barX + 1, barY + 1, barFillWidth, barHeight - 2, SSD1306_WHITE);
-
-    // Print progress percentage
-    uint16_t posY = barY + barHeight + 5;
-    String progressText = String(otaProgress) + "%";
-    int16_t x1, y1;
-    uint16_t textWidth, textHeight;
-
-    // Calculate the width of the progress text
-    leftDisplay.getTextBounds(progressText, 0, 0, &x1, &y1, &textWidth, &textHeight);
-    leftDisplay.setCursor((leftDisplay.width() - textWidth) / 2, posY);
-    leftDisplay.print(progressText);
+    uint16_t progress = otaProgress;
+    printOtaValues(leftDisplay, progress);
+    printOtaValues(rightDisplay, progress);
+}
 
-    rightDisplay.getTextBounds(progressText, 0, 0, &x1, &y1, &textWidth, &textHeight);
-    rightDisplay.setCursor((rightDisplay.width() - textWidth) / 2, posY);
-    rightDisplay.print(progressText);
+/**
+ * @brief Returns the time until the screen has to be refreshed without any event.
+ *
+ * @param displayEnabled False once the displays are powered off.
+ */
+TickType_t refreshTimeout(bool displayEnabled)
+{
+    uint32_t now = millis();
 
-    // Update the displays
-    leftDisplay.display();
-    rightDisplay.display();
+    switch (currentState)
+    {
+        case DISPLAY_OFF:
+            // Nothing to refresh, only a state change is awaited
+            return displayEnabled ? 0 : portMAX_DELAY;
+        case DISPLAY_DEFAULT:
+            // Show every second of the uptime
+            return pdMS_TO_TICKS(1000 - now % 1000) + 1;
+        case DISPLAY_LOW_POWER:
+            // Toggle the blinking message in time
+            return pdMS_TO_TICKS(DISPLAY_BLINK_PERIOD_MS - now % DISPLAY_BLINK_PERIOD_MS) + 1;
+        default:
+            return pdMS_TO_TICKS(DISPLAY_MIN_REFRESH_MS);
+    }
 }
 
 /**
@@ -278,51 +329,82 @@ void displayOtaUpdate()
  */
 void displayTask(void *pvParameters)
 {
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+    const TickType_t minFrameInterval = pdMS_TO_TICKS(1000 / DISPLAY_MAX_FPS);
+    TickType_t lastFrameTick = xTaskGetTickCount() - minFrameInterval;
+    uint32_t events = DISPLAY_EVENT_STATE; // Render the first frame right away
     bool displayEnabled = true;
+    DisplayState backgroundState = DISPLAY_OFF; // Screen whose static parts are prerendered
 
-    // Initialize the I2C bus
+    // Initialize the I2C bus, Wire installs the ESP-IDF driver used by the display bus task
     Wire.begin();
+    Wire.setClock(DISPLAY_I2C_CLOCK_HZ);
+    if (!displayBus.begin())
+        vTaskDelete(NULL);
 
     // Setup the displays
-    setupDisplay(leftDisplay, LEFT_SCREEN_ADDRESS);
-    setupDisplay(rightDisplay, RIGHT_SCREEN_ADDRESS);
+    setupDisplay(leftPanel);
+    setupDisplay(rightPanel);
 
-    Serial.println("displayTask started");
+    taskStartMs = millis();
+    LOG_INFO("displayTask started");
 
     // Main task loop
     for (;;)
     {
+        // Sleep until something changes, the watchdog refreshes the screen anyway
+        if (!events)
+        {
+            bool watchdog = xTaskNotifyWait(0, UINT32_MAX, &events, refreshTimeout(displayEnabled)) == pdFALSE;
+            countWakeup(watchdog);
+        }
+
+        // Limit the frame rate, the events arriving meanwhile are shown in the same frame
+        TickType_t sinceLastFrame = xTaskGetTickCount() - lastFrameTick;
+        if (sinceLastFrame < minFrameInterval)
+        {
+            vTaskDelay(minFrameInterval - sinceLastFrame);
+            xTaskNotifyWait(0, UINT32_MAX, NULL, 0);
+        }
+        lastFrameTick = xTaskGetTickCount();
+        events = 0;
+
+        uint32_t frameStartUs = esp_timer_get_time();
+        DisplayState state = currentState;
+
+        // The static parts of the screen are rendered only when the screen changes
+        if (state != backgroundState && state != DISPLAY_OFF)
+        {
+            renderBackgrounds(state);
+            backgroundState = state;
+        }
+
         // Update displays based on the current state
-        switch (currentState)
+        switch (state)
         {
             case DISPLAY_OFF:
                 if (displayEnabled)
                 {
                     // Power off the displays
-                    displayOff(leftDisplay);
-                    displayOff(rightDisplay);
+                    bool leftIdle = leftPanel.powerOff();
+                    bool rightIdle = rightPanel.powerOff();
+                    if (!leftIdle || !rightIdle)
+                        LOG_WARN("Display bus busy, powering off anyway");
                     // Give the semaphore to indicate that the display is disabled
                     xSemaphoreGive(displayDisabledSemaphore);
                     displayEnabled = false;
                 }
-                // Idle task
-                xTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(100));
                 break;
             case DISPLAY_DEFAULT:
                 displayDefault();
-                // Delay to control the refresh rate
-                xTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(100));
+                flushDisplays(frameStartUs);
                 break;
             case DISPLAY_LOW_POWER:
                 displayLowPower();
-                // Delay to control the blink rate
-                xTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(500));
+                flushDisplays(frameStartUs);
                 break;
             case DISPLAY_OTA_UPDATE:
                 displayOtaUpdate();
-                // Delay to control the blink rate
-                xTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(100));
+                flushDisplays(frameStartUs);
                 break;
         }
     }
@@ -345,9 +427,9 @@ void displayTaskInit(void)
                                           DISPLAY_TASK_STACK_SIZE,
                                           NULL,
                                           DISPLAY_TASK_PRIORITY,
-                                          NULL,
+                                          &displayTaskHandle,
                                           DISPLAY_TASK_CORE))
     {
-        Serial.println("Failed to create displayTask");
+        LOG_ERROR("Failed to create displayTask");
     }
 }
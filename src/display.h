@@ -10,6 +10,10 @@
 #ifndef DISPLAY_H
 #define DISPLAY_H
 
+#include <stdint.h>
+
+#include "display_bus.h"
+
 enum DisplayState
 {
     DISPLAY_OFF,
@@ -18,9 +22,33 @@ enum DisplayState
     DISPLAY_OTA_UPDATE
 };
 
+// Events waking the display task up, passed to notifyDisplay()
+#define DISPLAY_EVENT_STATE     0x01 // The display state has changed
+#define DISPLAY_EVENT_BATTERY   0x02 // The controller battery voltage has changed
+#define DISPLAY_EVENT_TELEMETRY 0x04 // New data from the Excavator
+#define DISPLAY_EVENT_OTA       0x08 // The OTA update progress has changed
+
+// Refresh statistics of the display task
+struct DisplayStats
+{
+    uint32_t frames;            // Number of rendered frames
+    uint32_t skippedFrames;     // Frames not sent because nothing changed on either display
+    uint32_t pagesSent;         // Number of sent display pages (128x8 pixels)
+    uint32_t bytesSent;         // Total number of bytes sent over I2C
+    uint32_t bytesPerSecond;    // Bytes sent over I2C during the last second
+    uint32_t avgRenderUs;       // Average time to render and queue a frame in microseconds
+    uint32_t maxRenderUs;       // Longest time to render and queue a frame in microseconds
+    uint32_t wakeups;           // Number of display task wakeups
+    uint32_t watchdogRefreshes; // Wakeups caused by the minimum refresh timeout instead of an event
+    uint32_t savedWakeups;      // Wakeups saved compared to the former fixed 100 ms polling
+    DisplayBusStats bus;        // Statistics of the transfers running in the background
+};
+
 void displayTaskInit(void);
 void setDisplayState(DisplayState state);
 void setOTAProgress(uint16_t percentage);
 void disableDisplay(bool blocking = true);
+void notifyDisplay(uint32_t events);
+DisplayStats getDisplayStats(void);
 
 #endif // DISPLAY_H
\ No newline at end of file
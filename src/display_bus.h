@@ -0,0 +1,69 @@
+/**
+ * @file display_bus.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef DISPLAY_BUS_H
+#define DISPLAY_BUS_H
+
+#include <stdint.h>
+
+// Display dimensions
+#define SCREEN_WIDTH  128
+#define SCREEN_HEIGHT 64
+
+// The SSD1306 memory is organized in pages of 8 pixel rows, one byte per column
+#define SCREEN_PAGES       (SCREEN_HEIGHT / 8)
+#define SCREEN_BUFFER_SIZE (SCREEN_WIDTH * SCREEN_PAGES)
+
+// Bytes of one window transfer besides the pixel data: the address window commands and two control bytes
+#define DISPLAY_BUS_WINDOW_OVERHEAD 8
+
+// Statistics of the display bus
+struct DisplayBusStats
+{
+    uint32_t transfers;   // Number of completed window transfers
+    uint32_t errors;      // Transfers not acknowledged by a display
+    uint32_t queueWaits;  // Transfers that had to wait for a free queue slot
+    uint32_t lastFrameUs; // Time the bus was busy with the last frame in microseconds
+    uint32_t maxFrameUs;  // Longest time the bus was busy with one frame in microseconds
+};
+
+/**
+ * @brief Bus carrying the framebuffer windows to the SSD1306 displays.
+ *
+ * Transfers are queued and sent in the background, so the caller can render the next frame while
+ * the previous one is still on the wire. The SSD1306 I2C implementation can be replaced by a mock
+ * to run the renderer on a development machine.
+ */
+class DisplayBus
+{
+public:
+    virtual ~DisplayBus() = default;
+
+    /**
+     * @brief Queues a column range of one page for the display with the given address.
+     *
+     * The data is copied, so the caller may change its buffer right after the call returns.
+     * @return True if the transfer was queued, the transfer may still fail later (see errorCount()).
+     */
+    virtual bool writeWindow(uint8_t address, uint8_t page, uint8_t firstColumn, uint8_t lastColumn,
+                             const uint8_t *data) = 0;
+
+    /**
+     * @brief Waits until all queued transfers have been sent.
+     * @return True if the bus is idle, false if the timeout has expired.
+     */
+    virtual bool waitIdle(uint32_t timeoutMs) = 0;
+
+    /**
+     * @brief Returns the number of failed transfers since the start.
+     */
+    virtual uint32_t errorCount() const = 0;
+};
+
+#endif // DISPLAY_BUS_H
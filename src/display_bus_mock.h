@@ -0,0 +1,80 @@
+/**
+ * @file display_bus_mock.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef DISPLAY_BUS_MOCK_H
+#define DISPLAY_BUS_MOCK_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "display_bus.h"
+
+// Number of displays emulated by the mock bus
+#define MOCK_DISPLAY_BUS_PANELS 2
+
+/**
+ * @brief Display bus emulating the display memory of the SSD1306 displays.
+ *
+ * Transfers are applied immediately, so after a flush the emulated memory has to equal the rendered
+ * framebuffer. Failures can be injected to check that the renderer recovers from lost transfers.
+ * Has no dependency on the ESP32, intended for tests on a development machine.
+ */
+class MockDisplayBus : public DisplayBus
+{
+private:
+    uint8_t addresses[MOCK_DISPLAY_BUS_PANELS];
+    uint8_t memory[MOCK_DISPLAY_BUS_PANELS][SCREEN_BUFFER_SIZE] = {};
+    uint32_t errors = 0;
+
+public:
+    uint32_t transfers = 0;     // Number of applied window transfers
+    uint32_t bytes = 0;         // Bytes the transfers would take on the I2C bus
+    uint32_t failTransfers = 0; // Number of the next transfers to drop and count as failed
+
+    MockDisplayBus(uint8_t leftAddress, uint8_t rightAddress) : addresses{leftAddress, rightAddress} {}
+
+    bool writeWindow(uint8_t address, uint8_t page, uint8_t firstColumn, uint8_t lastColumn,
+                     const uint8_t *data) override
+    {
+        uint8_t *panel = gddram(address);
+        if (!panel || page >= SCREEN_PAGES || firstColumn > lastColumn || lastColumn >= SCREEN_WIDTH)
+            return false;
+
+        if (failTransfers)
+        {
+            failTransfers--;
+            errors++;
+            return true;
+        }
+
+        memcpy(panel + page * SCREEN_WIDTH + firstColumn, data, lastColumn - firstColumn + 1);
+        transfers++;
+        bytes += lastColumn - firstColumn + 1 + DISPLAY_BUS_WINDOW_OVERHEAD;
+        return true;
+    }
+
+    bool waitIdle([[maybe_unused]] uint32_t timeoutMs) override { return true; }
+
+    uint32_t errorCount() const override { return errors; }
+
+    /**
+     * @brief Returns the emulated display memory of the display, nullptr for an unknown address.
+     */
+    uint8_t *gddram(uint8_t address)
+    {
+        for (uint8_t i = 0; i < MOCK_DISPLAY_BUS_PANELS; i++)
+        {
+            if (addresses[i] == address)
+                return memory[i];
+        }
+        return nullptr;
+    }
+};
+
+#endif // DISPLAY_BUS_MOCK_H
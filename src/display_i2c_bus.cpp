@@ -0,0 +1,184 @@
+/**
+ * @file display_i2c_bus.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "display_i2c_bus.h"
+
+#include <string.h>
+#include <esp_timer.h>
+
+#include "logger.h"
+
+// Task parameters
+#define DISPLAY_BUS_TASK_STACK_SIZE (4 * 1024U)
+#define DISPLAY_BUS_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+#define DISPLAY_BUS_TASK_CORE       1 // Core 0 is used by the WiFi
+
+// Time to wait for a free queue slot and for one I2C transaction
+#define DISPLAY_BUS_QUEUE_TIMEOUT_MS 100
+#define DISPLAY_BUS_I2C_TIMEOUT_MS   20
+
+// First byte of every I2C transaction telling the display what follows
+#define SSD1306_CONTROL_COMMANDS 0x00
+#define SSD1306_CONTROL_DATA     0x40
+
+// SSD1306 commands setting the address window (horizontal addressing mode is set by Adafruit_SSD1306::begin())
+#define SSD1306_SET_COLUMN_ADDRESS 0x21
+#define SSD1306_SET_PAGE_ADDRESS   0x22
+
+// Window of one page queued for the bus task
+struct DisplayBusTransfer
+{
+    uint32_t queuedUs; // Time the transfer was queued in microseconds
+    uint8_t address;
+    uint8_t page;
+    uint8_t firstColumn;
+    uint8_t lastColumn;
+    uint8_t data[SCREEN_WIDTH];
+};
+
+/**
+ * @brief Creates the transfer queue and starts the bus task.
+ *
+ * @return True if the bus has started.
+ */
+bool I2cDisplayBus::begin(void)
+{
+    queue = xQueueCreate(DISPLAY_BUS_QUEUE_SIZE, sizeof(DisplayBusTransfer));
+    idleSemaphore = xSemaphoreCreateBinary();
+    if (!queue || !idleSemaphore)
+    {
+        LOG_ERROR("Failed to create display bus queue");
+        return false;
+    }
+
+    if (pdPASS != xTaskCreatePinnedToCore(busTask,
+                                          "displayBusTask",
+                                          DISPLAY_BUS_TASK_STACK_SIZE,
+                                          this,
+                                          DISPLAY_BUS_TASK_PRIORITY,
+                                          NULL,
+                                          DISPLAY_BUS_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create displayBusTask");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Queues a column range of one page, waits for a free slot if the queue is full.
+ */
+bool I2cDisplayBus::writeWindow(uint8_t address, uint8_t page, uint8_t firstColumn, uint8_t lastColumn,
+                                const uint8_t *data)
+{
+    if (!queue || page >= SCREEN_PAGES || firstColumn > lastColumn || lastColumn >= SCREEN_WIDTH)
+        return false;
+
+    DisplayBusTransfer transfer;
+    transfer.queuedUs = esp_timer_get_time();
+    transfer.address = address;
+    transfer.page = page;
+    transfer.firstColumn = firstColumn;
+    transfer.lastColumn = lastColumn;
+    memcpy(transfer.data, data, lastColumn - firstColumn + 1);
+
+    pending.fetch_add(1, std::memory_order_relaxed);
+    if (xQueueSend(queue, &transfer, 0) == pdTRUE)
+        return true;
+
+    queueWaits.fetch_add(1, std::memory_order_relaxed);
+    if (xQueueSend(queue, &transfer, pdMS_TO_TICKS(DISPLAY_BUS_QUEUE_TIMEOUT_MS)) == pdTRUE)
+        return true;
+
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief Waits until the bus task has sent all queued transfers.
+ */
+bool I2cDisplayBus::waitIdle(uint32_t timeoutMs)
+{
+    while (pending.load(std::memory_order_acquire))
+    {
+        if (xSemaphoreTake(idleSemaphore, pdMS_TO_TICKS(timeoutMs)) != pdTRUE)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns a consistent copy of the bus statistics.
+ */
+DisplayBusStats I2cDisplayBus::getStats(void) const
+{
+    DisplayBusStats copy = publishedStats.read();
+    copy.errors = errors.load(std::memory_order_relaxed);
+    copy.queueWaits = queueWaits.load(std::memory_order_relaxed);
+    return copy;
+}
+
+/**
+ * @brief Task sending the queued windows, the display task renders the next frame meanwhile.
+ *
+ * @param arg The I2cDisplayBus instance.
+ */
+void I2cDisplayBus::busTask(void *arg)
+{
+    I2cDisplayBus &bus = *static_cast<I2cDisplayBus *>(arg);
+    DisplayBusTransfer transfer;
+    uint8_t buffer[1 + SCREEN_WIDTH];
+    uint32_t frameStartUs = 0;
+    bool busy = false;
+
+    LOG_INFO("displayBusTask started");
+
+    for (;;)
+    {
+        if (xQueueReceive(bus.queue, &transfer, portMAX_DELAY) != pdTRUE)
+            continue;
+
+        // The frame starts with the first transfer queued while the bus was idle
+        if (!busy)
+        {
+            frameStartUs = transfer.queuedUs;
+            busy = true;
+        }
+
+        const uint8_t commands[] = {SSD1306_CONTROL_COMMANDS,
+                                    SSD1306_SET_PAGE_ADDRESS, transfer.page, transfer.page,
+                                    SSD1306_SET_COLUMN_ADDRESS, transfer.firstColumn, transfer.lastColumn};
+        size_t length = transfer.lastColumn - transfer.firstColumn + 1;
+        buffer[0] = SSD1306_CONTROL_DATA;
+        memcpy(buffer + 1, transfer.data, length);
+
+        TickType_t timeout = pdMS_TO_TICKS(DISPLAY_BUS_I2C_TIMEOUT_MS);
+        if (i2c_master_write_to_device(bus.port, transfer.address, commands, sizeof(commands), timeout) != ESP_OK ||
+            i2c_master_write_to_device(bus.port, transfer.address, buffer, length + 1, timeout) != ESP_OK)
+        {
+            bus.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            bus.stats.transfers++;
+        }
+
+        if (bus.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            busy = false;
+            bus.stats.lastFrameUs = (uint32_t)esp_timer_get_time() - frameStartUs;
+            if (bus.stats.lastFrameUs > bus.stats.maxFrameUs)
+                bus.stats.maxFrameUs = bus.stats.lastFrameUs;
+            xSemaphoreGive(bus.idleSemaphore);
+        }
+
+        bus.publishedStats.write(bus.stats);
+    }
+}
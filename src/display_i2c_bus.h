@@ -0,0 +1,64 @@
+/**
+ * @file display_i2c_bus.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef DISPLAY_I2C_BUS_H
+#define DISPLAY_I2C_BUS_H
+
+#include <atomic>
+#include <driver/i2c.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include "display_bus.h"
+#include "seqlock.h"
+
+// I2C clock of the display bus, the SSD1306 displays usually work up to 1 MHz
+#ifndef DISPLAY_I2C_CLOCK_HZ
+#define DISPLAY_I2C_CLOCK_HZ 800000UL
+#endif
+
+// Number of queued window transfers, enough for a whole frame of both displays
+#define DISPLAY_BUS_QUEUE_SIZE (2 * SCREEN_PAGES)
+
+/**
+ * @brief Display bus sending the queued windows from its own task through the ESP-IDF I2C driver.
+ *
+ * The driver has to be installed on the port before begin() (Wire.begin() does it for I2C_NUM_0).
+ * The Adafruit_SSD1306 library may keep using Wire for the initialization and single commands,
+ * the driver serializes them with the queued transfers.
+ */
+class I2cDisplayBus : public DisplayBus
+{
+private:
+    i2c_port_t port;
+    QueueHandle_t queue = nullptr;
+    SemaphoreHandle_t idleSemaphore = nullptr;
+    std::atomic<uint32_t> pending{0}; // Queued transfers not sent yet
+    std::atomic<uint32_t> errors{0};
+    std::atomic<uint32_t> queueWaits{0};
+
+    // Statistics, updated only from the bus task
+    DisplayBusStats stats = {};
+    SeqLock<DisplayBusStats> publishedStats;
+
+    static void busTask(void *arg);
+
+public:
+    explicit I2cDisplayBus(i2c_port_t _port = I2C_NUM_0) : port(_port) {}
+
+    bool begin(void);
+    bool writeWindow(uint8_t address, uint8_t page, uint8_t firstColumn, uint8_t lastColumn,
+                     const uint8_t *data) override;
+    bool waitIdle(uint32_t timeoutMs) override;
+    uint32_t errorCount() const override { return errors.load(std::memory_order_relaxed); }
+    DisplayBusStats getStats(void) const;
+};
+
+#endif // DISPLAY_I2C_BUS_H
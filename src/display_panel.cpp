@@ -0,0 +1,126 @@
+/**
+ * @file display_panel.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "display_panel.h"
+
+#include <string.h>
+
+/**
+ * @brief Initializes the display, the first flush sends the whole frame.
+ *
+ * @return True if the display was initialized, false otherwise.
+ */
+bool DisplayPanel::begin(void)
+{
+    validPages = 0;
+    busErrors = bus.errorCount();
+
+    // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
+    if (!display.begin(SSD1306_SWITCHCAPVCC, address))
+        return false;
+
+    display.setTextColor(SSD1306_WHITE);
+    display.setTextSize(1);
+    return true;
+}
+
+/**
+ * @brief Queues the changed columns of one page of the framebuffer.
+ *
+ * @return One page and the queued bytes if the page changed, zeros otherwise.
+ */
+PanelFlushResult DisplayPanel::flushPage(uint8_t page)
+{
+    // A failed transfer leaves the display memory in an unknown state, send everything again
+    // (the failures are counted by the bus and reported in the display statistics)
+    uint32_t errors = bus.errorCount();
+    if (errors != busErrors)
+    {
+        busErrors = errors;
+        validPages = 0;
+    }
+
+    const uint8_t *row = display.getBuffer() + page * SCREEN_WIDTH;
+    uint8_t *sentRow = sent + page * SCREEN_WIDTH;
+    uint8_t pageBit = 1 << page;
+
+    // Find the range of the changed columns
+    uint8_t first = 0;
+    uint8_t last = SCREEN_WIDTH - 1;
+    if (validPages & pageBit)
+    {
+        while (first < SCREEN_WIDTH && row[first] == sentRow[first])
+            first++;
+        if (first == SCREEN_WIDTH)
+            return {0, 0}; // Page didn't change
+        while (row[last] == sentRow[last])
+            last--;
+    }
+
+    if (!bus.writeWindow(address, page, first, last, row + first))
+    {
+        validPages &= ~pageBit;
+        return {0, 0};
+    }
+
+    memcpy(sentRow + first, row + first, last - first + 1);
+    validPages |= pageBit;
+    return {1, (uint16_t)(last - first + 1 + DISPLAY_BUS_WINDOW_OVERHEAD)};
+}
+
+/**
+ * @brief Queues the parts of the framebuffer changed since the last flush.
+ *
+ * @return The number of changed pages and the queued bytes, both zero if the frame didn't change.
+ */
+PanelFlushResult DisplayPanel::flush(void)
+{
+    PanelFlushResult result = {0, 0};
+
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++)
+    {
+        PanelFlushResult pageResult = flushPage(page);
+        result.pages += pageResult.pages;
+        result.bytes += pageResult.bytes;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Saves the framebuffer as the background of the following frames.
+ */
+void DisplayPanel::saveBackground(void)
+{
+    memcpy(background, display.getBuffer(), SCREEN_BUFFER_SIZE);
+}
+
+/**
+ * @brief Starts a new frame from the saved background instead of a cleared framebuffer.
+ */
+void DisplayPanel::restoreBackground(void)
+{
+    memcpy(display.getBuffer(), background, SCREEN_BUFFER_SIZE);
+}
+
+/**
+ * @brief Clears and powers off the display (the lowest power consumption).
+ *
+ * @return True if the cleared frame was sent before the power off command, false if the bus stayed busy.
+ */
+bool DisplayPanel::powerOff(void)
+{
+    display.clearDisplay();
+    flush();
+
+    // The command goes through Wire, so it must not overtake the queued frame
+    bool idle = bus.waitIdle(PANEL_POWER_OFF_TIMEOUT_MS);
+    display.ssd1306_command(SSD1306_DISPLAYOFF);
+    return idle;
+}
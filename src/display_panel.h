@@ -0,0 +1,65 @@
+/**
+ * @file display_panel.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef DISPLAY_PANEL_H
+#define DISPLAY_PANEL_H
+
+#include <stdint.h>
+#include <Adafruit_SSD1306.h>
+
+#include "display_bus.h"
+
+// Time to wait for the queued transfers before powering the display off
+#define PANEL_POWER_OFF_TIMEOUT_MS 200
+
+// Result of sending the changes of one frame
+struct PanelFlushResult
+{
+    uint8_t pages;  // Number of pages with changes
+    uint16_t bytes; // Number of bytes queued for the bus including the command and control bytes
+};
+
+/**
+ * @brief SSD1306 panel sending only the changed parts of the framebuffer.
+ *
+ * The frame is drawn into the Adafruit_SSD1306 buffer as usual. flush() compares it page by page with
+ * a copy of the last sent frame and sends only the column range between the first and the last changed
+ * column of every changed page, so an unchanged frame costs no I2C traffic at all. The windows are queued
+ * on the display bus, pages of several displays can be interleaved by flushing them page by page.
+ *
+ * The static parts of a screen (titles, labels, outlines) can be rendered once and saved as the background,
+ * every frame then starts from a copy of it and draws only the values.
+ */
+class DisplayPanel
+{
+private:
+    Adafruit_SSD1306 &display;
+    DisplayBus &bus;
+    uint8_t address;
+    uint8_t sent[SCREEN_BUFFER_SIZE];       // Content of the display memory
+    uint8_t background[SCREEN_BUFFER_SIZE]; // Prerendered static parts of the current screen
+    uint8_t validPages = 0;                 // Bit for every page whose content in the display memory is known
+    uint32_t busErrors = 0;                 // Error count of the bus seen at the last flush
+
+    static_assert(SCREEN_PAGES <= 8, "Valid pages must fit into the bit mask");
+
+public:
+    DisplayPanel(Adafruit_SSD1306 &_display, DisplayBus &_bus, uint8_t _address)
+        : display(_display), bus(_bus), address(_address) {}
+
+    bool begin(void);
+    PanelFlushResult flushPage(uint8_t page);
+    PanelFlushResult flush(void);
+    bool powerOff(void);
+    void saveBackground(void);
+    void restoreBackground(void);
+    void invalidate(void) { validPages = 0; }
+};
+
+#endif // DISPLAY_PANEL_H
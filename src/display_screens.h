@@ -0,0 +1,144 @@
+/**
+ * @file display_screens.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef DISPLAY_SCREENS_H
+#define DISPLAY_SCREENS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+
+#include "battery_curves.h"
+#include "display_bus.h"
+
+/*
+ * Drawing of the screens, split into the static parts (rendered once per screen into the background)
+ * and the values drawn over the background every frame. The values are formatted into fixed stack
+ * buffers and measured with the fixed-width font, so a frame allocates nothing from the heap.
+ * Everything draws to an Adafruit_GFX, so the screens can be rendered into an off-screen canvas too.
+ */
+
+// Built-in fixed-width font of Adafruit_GFX: 5x7 glyphs in 6x8 pixel cells, scaled by the text size
+#define FONT_CHAR_WIDTH 6
+#define TEXT_WIDTH(length, size) ((int16_t)(length) * FONT_CHAR_WIDTH * (size))
+
+// Layout of the default screen
+#define BATTERY_ICON_WIDTH    16
+#define BATTERY_ICON_HEIGHT   8
+#define BATTERY_POLE_WIDTH    2
+#define BATTERY_POLE_HEIGHT   4
+#define BATTERY_ICON_X        (SCREEN_WIDTH - BATTERY_ICON_WIDTH - BATTERY_POLE_WIDTH)
+#define BATTERY_ICON_Y        0
+#define UPTIME_LABEL          "Uptime: "
+#define UPTIME_Y              8
+#define BATTERY_VOLTAGE_LABEL "Battery: "
+#define BATTERY_VOLTAGE_Y     56
+
+// Layout of the low power and OTA update screens
+#define LOW_POWER_LABEL "BAT: "
+#define OTA_BAR_WIDTH   100
+#define OTA_BAR_HEIGHT  10
+#define OTA_BAR_X       ((SCREEN_WIDTH - OTA_BAR_WIDTH) / 2)
+#define OTA_BAR_Y       ((SCREEN_HEIGHT - OTA_BAR_HEIGHT) / 2)
+
+/**
+ * @brief Prints the text with its top left corner at the given position.
+ */
+inline void printAt(Adafruit_GFX &display, int16_t x, int16_t y, uint8_t size, const char *text)
+{
+    display.setTextSize(size);
+    display.setCursor(x, y);
+    display.print(text);
+}
+
+/**
+ * @brief Draws the static parts of the default screen: the title, the battery outline and the labels.
+ */
+inline void drawTitleBackground(Adafruit_GFX &display, const char *title)
+{
+    printAt(display, 0, 0, 1, title);
+
+    // Draw the battery outline and pole
+    display.drawRect(BATTERY_ICON_X, BATTERY_ICON_Y, BATTERY_ICON_WIDTH, BATTERY_ICON_HEIGHT, SSD1306_WHITE);
+    display.fillRect(BATTERY_ICON_X + BATTERY_ICON_WIDTH, BATTERY_ICON_Y + (BATTERY_ICON_HEIGHT - BATTERY_POLE_HEIGHT) / 2,
+                     BATTERY_POLE_WIDTH, BATTERY_POLE_HEIGHT, SSD1306_WHITE);
+
+    printAt(display, 0, UPTIME_Y, 1, UPTIME_LABEL);
+    printAt(display, 0, BATTERY_VOLTAGE_Y, 1, BATTERY_VOLTAGE_LABEL);
+}
+
+/**
+ * @brief Draws the values of the default screen over its background.
+ */
+inline void printTitleValues(Adafruit_GFX &display, uint16_t batteryVoltage, uint16_t uptimeSec)
+{
+    char text[12];
+
+    // Draw the battery level
+    uint8_t batteryLevel = batteryCurveLevel(batteryVoltage);
+    display.fillRect(BATTERY_ICON_X + 1, BATTERY_ICON_Y + 1, (BATTERY_ICON_WIDTH - 2) * batteryLevel / 100,
+                     BATTERY_ICON_HEIGHT - 2, SSD1306_WHITE);
+
+    // Print the battery percentage with right-alignment
+    snprintf(text, sizeof(text), "%u%%", batteryLevel);
+    printAt(display, BATTERY_ICON_X - TEXT_WIDTH(strlen(text), 1) - 3, BATTERY_ICON_Y, 1, text);
+
+    snprintf(text, sizeof(text), "%u", uptimeSec);
+    printAt(display, TEXT_WIDTH(sizeof(UPTIME_LABEL) - 1, 1), UPTIME_Y, 1, text);
+
+    // Print voltage in Volts
+    snprintf(text, sizeof(text), "%u.%03uV", batteryVoltage / 1000, batteryVoltage % 1000);
+    printAt(display, TEXT_WIDTH(sizeof(BATTERY_VOLTAGE_LABEL) - 1, 1), BATTERY_VOLTAGE_Y, 1, text);
+}
+
+/**
+ * @brief Draws the values of the low power screen over its background.
+ *
+ * @param message The blinking message, nullptr while it is hidden.
+ * @param messageX Horizontal position of the message.
+ */
+inline void printLowPowerValues(Adafruit_GFX &display, uint16_t batteryVoltage, const char *message, int16_t messageX)
+{
+    // Print voltage in Volts rounded to hundredths
+    char text[12];
+    uint16_t centivolts = (batteryVoltage + 5) / 10;
+    snprintf(text, sizeof(text), "%u.%02uV", centivolts / 100, centivolts % 100);
+    printAt(display, TEXT_WIDTH(sizeof(LOW_POWER_LABEL) - 1, 2), 0, 2, text);
+
+    if (message)
+        printAt(display, messageX, 20, 3, message);
+}
+
+/**
+ * @brief Draws the static parts of the OTA update screen: the title and the progress bar outline.
+ */
+inline void drawOtaBackground(Adafruit_GFX &display, const char *title)
+{
+    printAt(display, 5, 0, 2, title);
+    display.drawRect(OTA_BAR_X, OTA_BAR_Y, OTA_BAR_WIDTH, OTA_BAR_HEIGHT, SSD1306_WHITE);
+}
+
+/**
+ * @brief Draws the progress of the OTA update over its background.
+ */
+inline void printOtaValues(Adafruit_GFX &display, uint16_t progress)
+{
+    // Fill the progress bar based on the progress percentage
+    uint16_t barFillWidth = (OTA_BAR_WIDTH - 2) * (progress < 100 ? progress : 100) / 100;
+    display.fillRect(OTA_BAR_X + 1, OTA_BAR_Y + 1, barFillWidth, OTA_BAR_HEIGHT - 2, SSD1306_WHITE);
+
+    // Print progress percentage centered under the bar
+    char text[8];
+    snprintf(text, sizeof(text), "%u%%", progress);
+    printAt(display, (SCREEN_WIDTH - TEXT_WIDTH(strlen(text), 1)) / 2, OTA_BAR_Y + OTA_BAR_HEIGHT + 5, 1, text);
+}
+
+#endif // DISPLAY_SCREENS_H
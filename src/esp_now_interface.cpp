@@ -8,118 +8,370 @@
  */
 
 #include "esp_now_interface.h"
-#include <esp_now.h>
-#include <WiFi.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 #include "constants.h"
 #include "data_structures.h"
+#include "esp_now_transport.h"
+#include "fast_boot.h"
 #include "leds.h"
+#include "link_rate.h"
+#include "logger.h"
+#include "rtt_stats.h"
+#include "sampling_task.h"
+#include "send_tracker.h"
+#include "seqlock.h"
+#include "udp_transport.h"
+#include "wire_format.h"
 
-// The MAC address of the Excavator got from platformio_override.ini
-uint8_t excavatorMac[] = {EXCAVATOR_MAC};
+// Task parameters
+#define RADIO_TASK_STACK_SIZE (4 * 1024U)
+#define RADIO_TASK_PRIORITY   (tskIDLE_PRIORITY + 5)
+#define RADIO_TASK_CORE       0 // Next to the WiFi stack
+
+// Radio task notification bits
+#define RADIO_EVENT_FRAME_POSTED 0x01 // New data in the mailbox
+#define RADIO_EVENT_SEND_DONE    0x02 // The frame in flight was delivered or failed
+#define RADIO_EVENT_HOLD         0x04 // Hold or release of the radio was requested
 
-// Create a structure to store the peer information
-esp_now_peer_info_t peerInfo;
+// Time to wait for the send callback before the frame in flight is considered lost
+#define RADIO_SEND_TIMEOUT_US (50 * 1000UL)
+// Delay before retrying when the transport buffers are full
+#define RADIO_BUSY_RETRY_MS 2
+
+#ifdef UDP_PEER_HOST
+// Frames are sent over UDP to the host given in platformio_override.ini (e.g. the simulated Excavator)
+UdpTransport transport(UDP_PEER_HOST);
+#else
+// The MAC address of the Excavator got from platformio_override.ini
+const uint8_t excavatorMac[] = {EXCAVATOR_MAC};
+EspNowTransport transport(excavatorMac);
+#endif
 
 // Variable to store a callback when data were received
-esp_now_recv_cb_t onDataReceivedCallback = NULL;
+TransportReceiveCallback onDataReceivedCallback = NULL;
 
-// Callback when data is sent
-void _onDataSent(const uint8_t *mac_addr, esp_now_send_status_t status)
+// Single-slot mailbox holding the newest data to be sent, older data is overwritten
+struct Mailbox
 {
-    // Indicate that the data was sent even if it possibly failed
-    blinkWithLed(LED_BUTTON_A);
+    controller_data_struct data;
+    uint32_t timestampUs; // Time the lever positions were sampled at, 0 if unknown
+    uint8_t flags;
+    bool pending;         // Data was posted and not yet taken by the radio task
+    uint32_t postedUs;    // Time of the first post not yet sent in microseconds
+    uint32_t posts;       // Number of posts, copied to the statistics by the radio task
+    uint32_t coalesced;   // Number of posts replaced before they were sent
+};
+
+Mailbox mailbox;
+portMUX_TYPE mailboxMux = portMUX_INITIALIZER_UNLOCKED;
+
+TaskHandle_t radioTaskHandle = NULL;
+SendTracker sendTracker;         // Frame in flight and its completion by the send callback
+uint32_t inFlightPostedUs = 0;   // Post time of the frame in flight
+uint32_t inFlightSentUs = 0;     // Time the frame in flight was passed to the transport
+bool inFlightUserActive = false; // The frame in flight carries user input, not a keepalive
+
+// Radio hold requested by holdRadio(), the semaphore is given once no frame is in flight
+volatile bool holdRequested = false;
+SemaphoreHandle_t radioHeldSemaphore = NULL;
+
+// Statistics, written only by the radio task
+RadioStats radioStats;
+SeqLock<RadioStats> publishedRadioStats;
+
+// Callback when data is sent, the completion is evaluated by the radio task
+void onFrameSent(bool delivered)
+{
+    sendTracker.complete(delivered, esp_timer_get_time());
+
+    // Let the radio task send the next frame
+    if (radioTaskHandle)
+        xTaskNotify(radioTaskHandle, RADIO_EVENT_SEND_DONE, eSetBits);
 }
 
-void setupDataRecvCallback(esp_now_recv_cb_t callback)
+void setupDataRecvCallback(TransportReceiveCallback callback)
 {
     onDataReceivedCallback = callback;
 }
 
-void setupPeer()
+/**
+ * @brief Starts the transport to the Excavator.
+ *
+ * @note This function should be called every time the WiFi interface becomes ready.
+ */
+void initTransport()
+{
+    if (transport.begin(onFrameSent, onDataReceivedCallback))
+        LOG_INFO("%s transport started", transport.name());
+}
+
+/**
+ * @brief Posts the data to be sent to the Excavator.
+ *
+ * The data is placed into a single-slot mailbox and sent by the radio task as soon as no other frame
+ * is in flight. Data posted before the previous post was sent is replaced, so only the newest data
+ * is ever sent. The function never blocks.
+ *
+ * @param data The controller data.
+ * @param flags WIRE_FLAG_* bits of the frame.
+ * @param timestampUs Time the lever positions were sampled at. If set, the v3 frames carry the lever
+ * samples taken before it.
+ */
+void sendDataToExcavator(const controller_data_struct &data, uint8_t flags, uint32_t timestampUs)
+{
+    portENTER_CRITICAL(&mailboxMux);
+    if (mailbox.pending)
+        mailbox.coalesced++;
+    else
+        mailbox.postedUs = esp_timer_get_time();
+    mailbox.data = data;
+    mailbox.timestampUs = timestampUs;
+    mailbox.flags = flags;
+    mailbox.pending = true;
+    mailbox.posts++;
+    portEXIT_CRITICAL(&mailboxMux);
+
+    if (radioTaskHandle)
+        xTaskNotify(radioTaskHandle, RADIO_EVENT_FRAME_POSTED, eSetBits);
+}
+
+/**
+ * @brief Takes the newest data from the mailbox, encodes it and passes it to the transport.
+ *
+ * @return True if a frame is in flight now, false otherwise.
+ */
+bool sendMailbox()
 {
-    // Check if the peer has already been set
-    static boolean peerSet = false;
+    Mailbox entry;
+
+    // Continue only if the transport can send (e.g. WiFi interface is in valid mode), the data stays in the mailbox
+    if (!transport.isReady())
+        return false;
+
+    portENTER_CRITICAL(&mailboxMux);
+    entry = mailbox;
+    mailbox.pending = false;
+    portEXIT_CRITICAL(&mailboxMux);
+
+    radioStats.framesPosted = entry.posts;
+    radioStats.framesCoalesced = entry.coalesced;
+
+    if (!entry.pending)
+        return false;
+
+    // Attach the previous lever samples in the streaming mode, the power off frame has no valid history
+    LeverSample history[WIRE_V3_HISTORY_MAX];
+    uint8_t historyCount = 0;
+    if (getProtocolVersion() >= WIRE_PROTOCOL_V3 && entry.timestampUs && !(entry.flags & WIRE_FLAG_POWER_OFF))
+        historyCount = readLeverHistory(entry.timestampUs, history, WIRE_V3_HISTORY_MAX);
+
+    // Encode the data using the protocol version negotiated with the Excavator
+    uint8_t frame[WIRE_FRAME_MAX_SIZE];
+    WireHeader header;
+    size_t frameLength = encodeControllerFrame(entry.data, entry.flags, frame, header,
+                                               entry.timestampUs, history, historyCount);
+
+    // Attempt to send the data
+    inFlightPostedUs = entry.postedUs;
+    inFlightSentUs = esp_timer_get_time();
+    inFlightUserActive = !(entry.flags & WIRE_FLAG_KEEPALIVE);
+    TransportStatus result = transport.send(frame, frameLength);
+
+    if (result == TRANSPORT_OK)
+    {
+        // Only a transmitted frame consumes its sequence number, so the retries don't appear as drops
+        controllerFrameSent(header);
+
+        // Remember the send time to measure the round trip when the Excavator echoes the sequence number
+        if (header.version >= WIRE_PROTOCOL_V2)
+            rttFrameSent(header.sequence);
+
+        fastBootFirstFrameSent();
+
+        uint32_t now = esp_timer_get_time();
+        sendTracker.frameSent(now);
+        uint32_t queueUs = now - entry.postedUs;
+        radioStats.framesSent++;
+        radioStats.maxPostToSendUs = max(radioStats.maxPostToSendUs, queueUs);
+        radioStats.avgPostToSendUs += ((int32_t)queueUs - (int32_t)radioStats.avgPostToSendUs) / 16;
 
-    if (peerSet)
+        // End-to-end latency from the ADC frame, unknown for the data without a timestamp
+        if (entry.timestampUs)
+        {
+            uint32_t sampleUs = now - entry.timestampUs;
+            radioStats.maxSampleToSendUs = max(radioStats.maxSampleToSendUs, sampleUs);
+            radioStats.avgSampleToSendUs += ((int32_t)sampleUs - (int32_t)radioStats.avgSampleToSendUs) / 16;
+        }
+        return true;
+    }
+
+    if (result == TRANSPORT_BUSY)
+    {
+        // Put the data back unless newer data was posted meanwhile, it will be retried shortly
+        portENTER_CRITICAL(&mailboxMux);
+        if (!mailbox.pending)
+        {
+            mailbox.data = entry.data;
+            mailbox.timestampUs = entry.timestampUs;
+            mailbox.flags = entry.flags;
+            mailbox.postedUs = entry.postedUs;
+            mailbox.pending = true;
+        }
+        portEXIT_CRITICAL(&mailboxMux);
+        radioStats.busyRetries++;
+    }
+    else
     {
-        // Peer has already been set - return
-        return;
+        radioStats.sendErrors++;
     }
 
-    // Setup the peer
-    memcpy(peerInfo.peer_addr, excavatorMac, 6);
-    peerInfo.channel = 0;
-    peerInfo.encrypt = false;
+    return false;
+}
+
+/**
+ * @brief Stops sending frames as soon as the frame in flight is completed.
+ *
+ * Posted data is kept in the mailbox and sent after releaseRadio(). Used to get a short window for
+ * the peripherals sharing the radio (ADC2) right after a completed transmission.
+ *
+ * @param timeoutMs Maximum time to wait for the frame in flight in milliseconds.
+ * @return True if the radio is held, false if the wait timed out (the radio is not held then).
+ */
+bool holdRadio(uint32_t timeoutMs)
+{
+    if (!radioTaskHandle)
+        return true;
 
-    peerSet = true;
+    // Drop a confirmation left from an earlier timed out request
+    xSemaphoreTake(radioHeldSemaphore, 0);
+
+    holdRequested = true;
+    xTaskNotify(radioTaskHandle, RADIO_EVENT_HOLD, eSetBits);
+
+    if (xSemaphoreTake(radioHeldSemaphore, pdMS_TO_TICKS(timeoutMs)) == pdTRUE)
+        return true;
+
+    releaseRadio();
+    return false;
 }
 
-void initEspNow()
+/**
+ * @brief Resumes sending frames after holdRadio(), the data posted meanwhile is sent immediately.
+ */
+void releaseRadio()
 {
-    // Init ESP-NOW
-    if (esp_now_init() != ESP_OK)
-    {
-        Serial.println("Error initializing ESP-NOW");
-        return;
-    }
+    holdRequested = false;
+
+    if (radioTaskHandle)
+        xTaskNotify(radioTaskHandle, RADIO_EVENT_HOLD, eSetBits);
+}
 
-    // Set up the peer if it hasn't been set up yet
-    setupPeer();
+/**
+ * @brief Evaluates the completion of the frame in flight signaled by the send callback.
+ *
+ * @return True if the frame in flight is completed, false for a late completion of a timed out frame.
+ */
+bool completeFrameInFlight()
+{
+    bool delivered;
+    uint32_t doneUs;
 
-    // Add the peer
-    if (esp_now_add_peer(&peerInfo) != ESP_OK)
+    if (!sendTracker.takeCompletion(delivered, doneUs))
     {
-        Serial.println("Failed to add peer");
-        return;
+        radioStats.staleCompletions = sendTracker.staleCount();
+        return false;
     }
 
-    // Register for a callback function that will be called when data is sent
-    esp_now_register_send_cb(_onDataSent);
+    // Measure the time from posting the data to the completion of the transmission
+    radioStats.maxPostToDoneUs = max(radioStats.maxPostToDoneUs, doneUs - inFlightPostedUs);
 
-    esp_now_register_recv_cb(onDataReceivedCallback);
+    // Adapt the send rate to the delivery status and the MAC-level latency
+    linkRateReport(delivered, doneUs - inFlightSentUs, inFlightUserActive);
+
+    // Indicate that the data was sent even if it possibly failed (not from the WiFi task, it may allocate)
+    blinkWithLed(LED_BUTTON_A);
+    return true;
 }
 
-void sendDataToExcavator(const controller_data_struct &data)
+/**
+ * @brief Task sending the mailbox data with exactly one frame in flight.
+ *
+ * @param pvParameters A pointer to task parameters (not used in this function).
+ */
+void radioTask(void *pvParameters)
 {
-#define NO_MEM_RETRY_INTERVAL 1000
-    static unsigned long lastSendTime = 0;
-    static bool awaitingRetry = false;
-    static bool wasMemErrorLastTime = false;
+    bool held = false;
+
+    for (;;)
+    {
+        uint32_t events = 0;
+        TickType_t timeout = portMAX_DELAY;
 
-    // Continue only if WiFi interface is in valid mode
-    if (WiFi.getMode() != WIFI_AP_STA && WiFi.getMode() != WIFI_AP)
-        return;
+        // Wait only for the rest of the timeout, frequent posts must not postpone it
+        if (sendTracker.isInFlight())
+            timeout = pdMS_TO_TICKS(sendTracker.remainingUs(esp_timer_get_time(), RADIO_SEND_TIMEOUT_US) / 1000 + 1);
+        else if (mailbox.pending && !held)
+            timeout = pdMS_TO_TICKS(RADIO_BUSY_RETRY_MS); // Retry after TRANSPORT_BUSY
 
-    // Check if we are waiting to retry and if the wait time has elapsed
-    if (awaitingRetry && millis() - lastSendTime < NO_MEM_RETRY_INTERVAL)
-        return; // Exit the function early if we are still waiting to retry
+        xTaskNotifyWait(0, UINT32_MAX, &events, timeout);
 
-    // Attempt to send the data
-    esp_err_t result = esp_now_send(excavatorMac, (uint8_t *)&data, sizeof(data));
+        if (events & RADIO_EVENT_SEND_DONE)
+            completeFrameInFlight();
 
-    // Handle the result of the send attempt
-    if (result == ESP_ERR_ESPNOW_NO_MEM)
-    {
-        if (wasMemErrorLastTime)
+        // The send callback didn't come in time, count the frame as lost (a late callback is ignored)
+        if (sendTracker.checkTimeout(esp_timer_get_time(), RADIO_SEND_TIMEOUT_US))
         {
-            // Log the error if this is the second consecutive ESP_ERR_ESPNOW_NO_MEM
-            Serial.printf("Error sending data after retry: %s\n", esp_err_to_name(result));
+            radioStats.sendTimeouts++;
+            linkRateReport(false, RADIO_SEND_TIMEOUT_US, inFlightUserActive);
         }
-        // Set up for a retry
-        lastSendTime = millis();
-        awaitingRetry = true;
-        wasMemErrorLastTime = true;
-    }
-    else
-    {
-        // If the send was successful or failed for a reason other than ESP_ERR_ESPNOW_NO_MEM, reset retry state
-        awaitingRetry = false;
-        wasMemErrorLastTime = false;
-        if (result != ESP_OK)
+
+        bool inFlight = sendTracker.isInFlight();
+
+        // Confirm the hold only between the transmissions, the frame in flight is completed first
+        if (!inFlight && holdRequested)
+        {
+            if (!held)
+                xSemaphoreGive(radioHeldSemaphore);
+            held = true;
+        }
+        else if (!inFlight)
         {
-            // Log the error if it's not ESP_OK and not ESP_ERR_ESPNOW_NO_MEM
-            Serial.printf("Error sending data: %s\n", esp_err_to_name(result));
+            held = false;
+            sendMailbox();
         }
+
+        publishedRadioStats.write(radioStats);
+    }
+}
+
+/**
+ * @brief Initializes the radio task.
+ *
+ * @note This function should be called once during the setup phase of the program.
+ */
+void radioTaskInit(void)
+{
+    radioHeldSemaphore = xSemaphoreCreateBinary();
+
+    if (pdPASS != xTaskCreatePinnedToCore(radioTask,
+                                          "radioTask",
+                                          RADIO_TASK_STACK_SIZE,
+                                          NULL,
+                                          RADIO_TASK_PRIORITY,
+                                          &radioTaskHandle,
+                                          RADIO_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create radioTask");
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Returns a consistent copy of the radio statistics.
+ */
+RadioStats getRadioStats(void)
+{
+    return publishedRadioStats.read();
+}
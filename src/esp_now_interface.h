@@ -10,12 +10,32 @@
 #ifndef ESP_NOW_INTERFACE_H
 #define ESP_NOW_INTERFACE_H
 
-#include <esp_now.h>
-
 #include "data_structures.h"
+#include "transport.h"
+
+// Statistics of the radio task
+struct RadioStats
+{
+    uint32_t framesPosted;      // Data posted by sendDataToExcavator()
+    uint32_t framesCoalesced;   // Data replaced by newer data before it was sent
+    uint32_t framesSent;        // Frames accepted by the transport
+    uint32_t busyRetries;       // Sends retried because the transport buffers were full
+    uint32_t sendErrors;        // Sends failed for other reasons
+    uint32_t sendTimeouts;      // Frames without the send callback in time
+    uint32_t staleCompletions;  // Late send callbacks of timed out frames, ignored
+    uint32_t avgPostToSendUs;   // Average time from posting the data to passing it to the transport
+    uint32_t maxPostToSendUs;   // Maximum time from posting the data to passing it to the transport
+    uint32_t maxPostToDoneUs;   // Maximum time from posting the data to the completed transmission
+    uint32_t avgSampleToSendUs; // Average time from the ADC frame to passing the data to the transport
+    uint32_t maxSampleToSendUs; // Maximum time from the ADC frame to passing the data to the transport
+};
 
-void initEspNow();
-void setupDataRecvCallback(esp_now_recv_cb_t callback);
-void sendDataToExcavator(const controller_data_struct &data);
+void initTransport();
+void radioTaskInit(void);
+bool holdRadio(uint32_t timeoutMs);
+void releaseRadio(void);
+RadioStats getRadioStats(void);
+void setupDataRecvCallback(TransportReceiveCallback callback);
+void sendDataToExcavator(const controller_data_struct &data, uint8_t flags = 0, uint32_t timestampUs = 0);
 
 #endif // ESP_NOW_INTERFACE_H
\ No newline at end of file
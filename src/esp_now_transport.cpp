@@ -0,0 +1,85 @@
+/**
+ * @file esp_now_transport.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "esp_now_transport.h"
+
+#include <WiFi.h>
+
+#include "logger.h"
+
+TransportSendCallback EspNowTransport::sendCallback = NULL;
+TransportReceiveCallback EspNowTransport::receiveCallback = NULL;
+
+EspNowTransport::EspNowTransport(const uint8_t *peerMac)
+{
+    // Setup the peer
+    memcpy(peerInfo.peer_addr, peerMac, ESP_NOW_ETH_ALEN);
+    peerInfo.channel = 0;
+    peerInfo.encrypt = false;
+}
+
+void EspNowTransport::onDataSent(const uint8_t *mac_addr, esp_now_send_status_t status)
+{
+    if (sendCallback)
+        sendCallback(status == ESP_NOW_SEND_SUCCESS);
+}
+
+void EspNowTransport::onDataReceived(const uint8_t *mac_addr, const uint8_t *data, int len)
+{
+    if (receiveCallback)
+        receiveCallback(mac_addr, data, len);
+}
+
+bool EspNowTransport::begin(TransportSendCallback onSent, TransportReceiveCallback onReceived)
+{
+    sendCallback = onSent;
+    receiveCallback = onReceived;
+
+    // Init ESP-NOW
+    if (esp_now_init() != ESP_OK)
+    {
+        LOG_ERROR("Error initializing ESP-NOW");
+        return false;
+    }
+
+    // Add the peer, it already exists when the WiFi interface becomes ready again
+    esp_err_t result = esp_now_add_peer(&peerInfo);
+    if (result != ESP_OK && result != ESP_ERR_ESPNOW_EXIST)
+    {
+        LOG_ERROR("Failed to add peer");
+        return false;
+    }
+
+    // Register for callback functions that will be called when data is sent and received
+    esp_now_register_send_cb(onDataSent);
+    esp_now_register_recv_cb(onDataReceived);
+
+    started = true;
+    return true;
+}
+
+bool EspNowTransport::isReady() const
+{
+    // ESP-NOW works only when the WiFi interface is in a valid mode
+    return started && (WiFi.getMode() == WIFI_AP_STA || WiFi.getMode() == WIFI_AP);
+}
+
+TransportStatus EspNowTransport::send(const uint8_t *data, size_t length)
+{
+    esp_err_t result = esp_now_send(peerInfo.peer_addr, data, length);
+
+    if (result == ESP_OK)
+        return TRANSPORT_OK;
+
+    if (result == ESP_ERR_ESPNOW_NO_MEM)
+        return TRANSPORT_BUSY;
+
+    LOG_ERROR("Error sending data: %s", esp_err_to_name(result));
+    return TRANSPORT_ERROR;
+}
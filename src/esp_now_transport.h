@@ -0,0 +1,43 @@
+/**
+ * @file esp_now_transport.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef ESP_NOW_TRANSPORT_H
+#define ESP_NOW_TRANSPORT_H
+
+#include <esp_now.h>
+
+#include "transport.h"
+
+/**
+ * @brief Transport sending the frames to a single ESP-NOW peer.
+ *
+ * ESP-NOW accepts only plain function callbacks, so only one instance may be started.
+ */
+class EspNowTransport : public Transport
+{
+private:
+    esp_now_peer_info_t peerInfo = {};
+    bool started = false;
+
+    static TransportSendCallback sendCallback;
+    static TransportReceiveCallback receiveCallback;
+
+    static void onDataSent(const uint8_t *mac_addr, esp_now_send_status_t status);
+    static void onDataReceived(const uint8_t *mac_addr, const uint8_t *data, int len);
+
+public:
+    explicit EspNowTransport(const uint8_t *peerMac);
+
+    bool begin(TransportSendCallback onSent, TransportReceiveCallback onReceived) override;
+    bool isReady() const override;
+    TransportStatus send(const uint8_t *data, size_t length) override;
+    const char *name() const override { return "ESP-NOW"; }
+};
+
+#endif // ESP_NOW_TRANSPORT_H
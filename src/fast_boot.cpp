@@ -0,0 +1,128 @@
+/**
+ * @file fast_boot.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "fast_boot.h"
+
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+#include "logger.h"
+
+// Marker of a valid fast boot state, change it when the layout of the state changes
+#define FAST_BOOT_MAGIC 0x46424F54 // "FBOT"
+
+// State kept in the RTC memory during the deep sleep
+struct FastBootState
+{
+    uint32_t magic;
+    uint16_t batteryMv;        // Last battery reading, 0 if none
+    uint8_t channel;           // Channel of the access point, 0 if unknown
+    uint8_t bssid[6];          // BSSID of the access point
+    uint32_t fastBoots;        // Fast boots since the last cold boot
+    uint32_t lastFirstFrameUs; // Time to the first frame of the last boot
+};
+
+RTC_DATA_ATTR FastBootState fastBootState;
+
+static BootStats bootStats;
+
+/**
+ * @brief Decides whether the fast path can be used, must be called first in setup().
+ */
+void fastBootInit(void)
+{
+    // The RTC memory is valid only after the deep sleep
+    bool woken = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0;
+    if (!woken || fastBootState.magic != FAST_BOOT_MAGIC)
+    {
+        memset(&fastBootState, 0, sizeof(fastBootState));
+        fastBootState.magic = FAST_BOOT_MAGIC;
+    }
+
+    bootStats.fastBoot = woken && fastBootState.batteryMv;
+    if (bootStats.fastBoot)
+        fastBootState.fastBoots++;
+    bootStats.fastBoots = fastBootState.fastBoots;
+    bootStats.previousFirstFrameUs = fastBootState.lastFirstFrameUs;
+}
+
+/**
+ * @brief Returns true if the current boot is a wake-up from the deep sleep with a valid RTC state.
+ */
+bool isFastBoot(void)
+{
+    return bootStats.fastBoot;
+}
+
+/**
+ * @brief Returns the battery voltage measured before the deep sleep in millivolts.
+ */
+uint16_t getFastBootBatteryMv(void)
+{
+    return fastBootState.batteryMv;
+}
+
+/**
+ * @brief Keeps the battery reading for the next wake-up.
+ */
+void fastBootSaveBattery(uint16_t batteryMv)
+{
+    fastBootState.batteryMv = batteryMv;
+}
+
+/**
+ * @brief Gets the access point the station was connected to before the deep sleep.
+ *
+ * @param channel The channel of the access point.
+ * @param bssid The BSSID of the access point (6 bytes).
+ * @return False if the access point is unknown.
+ */
+bool getFastBootAccessPoint(uint8_t &channel, uint8_t *bssid)
+{
+    if (!fastBootState.channel)
+        return false;
+
+    channel = fastBootState.channel;
+    memcpy(bssid, fastBootState.bssid, sizeof(fastBootState.bssid));
+    return true;
+}
+
+/**
+ * @brief Keeps the access point the station is connected to for the next wake-up.
+ */
+void fastBootSaveAccessPoint(uint8_t channel, const uint8_t *bssid)
+{
+    fastBootState.channel = channel;
+    memcpy(fastBootState.bssid, bssid, sizeof(fastBootState.bssid));
+}
+
+/**
+ * @brief Records the time to the first frame, called with every frame passed to the transport.
+ */
+void fastBootFirstFrameSent(void)
+{
+    if (bootStats.firstFrameUs)
+        return;
+
+    // The timer starts with the application, the ROM and bootloader time is not included
+    bootStats.firstFrameUs = esp_timer_get_time();
+    fastBootState.lastFirstFrameUs = bootStats.firstFrameUs;
+
+    LOG_INFO("First frame sent %u us after the %s boot (previous boot: %u us)", bootStats.firstFrameUs,
+             bootStats.fastBoot ? "fast" : "cold", bootStats.previousFirstFrameUs);
+}
+
+/**
+ * @brief Returns the boot statistics.
+ */
+BootStats getBootStats(void)
+{
+    return bootStats;
+}
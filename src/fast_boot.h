@@ -0,0 +1,43 @@
+/**
+ * @file fast_boot.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef FAST_BOOT_H
+#define FAST_BOOT_H
+
+#include <stdint.h>
+
+/*
+ * Fast boot after the deep sleep.
+ *
+ * The state needed to reach the first control frame quickly is kept in the RTC memory: the last battery
+ * reading and the channel and BSSID of the access point (ESP-NOW uses the channel of the station). After
+ * a wake-up by the power button the battery isn't measured before starting (it is measured later with
+ * the radio paused) and the WiFi joins the known access point without scanning all channels, so ESP-NOW
+ * sends on the right channel from the start. The lever calibration survives in the RTC memory as well.
+ */
+
+// Boot statistics
+struct BootStats
+{
+    bool fastBoot;                 // Current boot used the fast path
+    uint32_t firstFrameUs;         // Time from the boot to the first frame passed to the transport, 0 if not yet
+    uint32_t previousFirstFrameUs; // Time to the first frame of the previous boot
+    uint32_t fastBoots;            // Fast boots since the last cold boot
+};
+
+void fastBootInit(void);
+bool isFastBoot(void);
+uint16_t getFastBootBatteryMv(void);
+void fastBootSaveBattery(uint16_t batteryMv);
+bool getFastBootAccessPoint(uint8_t &channel, uint8_t *bssid);
+void fastBootSaveAccessPoint(uint8_t channel, const uint8_t *bssid);
+void fastBootFirstFrameSent(void);
+BootStats getBootStats(void);
+
+#endif // FAST_BOOT_H
@@ -0,0 +1,145 @@
+/**
+ * @file housekeeping_task.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "housekeeping_task.h"
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+#include "constants.h"
+#include "data_structures.h"
+#include "display.h"
+#include "esp_now_interface.h"
+#include "lever_calibration.h"
+#include "logger.h"
+#include "power_manager.h"
+#include "power_mode.h"
+#include "sampling_task.h"
+#include "serial_console.h"
+#include "wifi_ota_manager.h"
+#include "wire_format.h"
+
+// Task parameters
+#define HOUSEKEEPING_TASK_STACK_SIZE (4 * 1024U)
+#define HOUSEKEEPING_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+#define HOUSEKEEPING_TASK_CORE       1 // Core 0 is used by the WiFi
+
+// Period of the battery, inactivity and serial command checks in milliseconds
+#define HOUSEKEEPING_INTERVAL_MS 100
+
+// Global variables
+extern controller_data_struct dataToSend;
+extern volatile uint32_t lastUserActivityTime;
+
+TaskHandle_t housekeepingTaskHandle = NULL;
+
+void zeroLeversPositions()
+{
+    controller_data_struct data = readControllerSnapshot().data;
+
+    // Set all levers positions to 0
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        data.leverPositions[i] = 0;
+
+    // Send the data to the Excavator
+    sendDataToExcavator(data, WIRE_FLAG_POWER_OFF);
+
+    // Delay to allow the radio task to send the data
+    delay(100);
+}
+
+void powerOffBoard()
+{
+    // Zero all levers positions
+    zeroLeversPositions();
+
+    // Keep the lever calibration for the next start
+    saveLeverCalibration();
+
+    // Disable Wi-Fi
+    disableWiFi();
+
+    // Turn OFF the displays
+    disableDisplay();
+
+    // Turn OFF the board and LEDs power
+    digitalWrite(BOARD_POWER, LOW);
+    digitalWrite(LED_BUTTON_A, LOW);
+    digitalWrite(LED_BUTTON_B, LOW);
+    digitalWrite(LED_BUTTON_C, LOW);
+
+    // Go to deep sleep mode
+    go_to_deep_sleep();
+}
+
+/**
+ * @brief Task reading the battery voltage, handling the serial commands and powering off the board.
+ *
+ * @param pvParameters A pointer to task parameters (not used in this function).
+ */
+void housekeepingTask(void *pvParameters)
+{
+    for (;;)
+    {
+        // Wait for the next check or for the power off request
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HOUSEKEEPING_INTERVAL_MS)))
+            powerOffBoard();
+
+        handleSerialCommands();
+
+        // Lower the CPU frequency while the levers are at rest
+        powerModeUpdate();
+
+        // Read battery voltage every BATTERY_READ_INTERVAL, postponed while the levers are used
+        dataToSend.battery = readBatteryVoltage();
+
+        // The fast boot started with the reading stored before the deep sleep, the first measurement decides
+        if (isBatteryLow())
+        {
+            setDisplayState(DISPLAY_LOW_POWER);
+            delay(BATTERY_LOW_MESSAGE_MS);
+            powerOffBoard();
+        }
+
+        // Power off the board after a period of inactivity
+        if (millis() - lastUserActivityTime > INACTIVITY_PERIOD_FOR_POWER_OFF)
+        {
+            LOG_INFO("Powering off the board due to inactivity...");
+            powerOffBoard();
+        }
+    }
+}
+
+/**
+ * @brief Initializes the housekeeping task.
+ *
+ * @note This function should be called once during the setup phase of the program.
+ */
+void housekeepingTaskInit(void)
+{
+    if (pdPASS != xTaskCreatePinnedToCore(housekeepingTask,
+                                          "housekeepingTask",
+                                          HOUSEKEEPING_TASK_STACK_SIZE,
+                                          NULL,
+                                          HOUSEKEEPING_TASK_PRIORITY,
+                                          &housekeepingTaskHandle,
+                                          HOUSEKEEPING_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create housekeepingTask");
+    }
+}
+
+/**
+ * @brief Asks the housekeeping task to power off the board.
+ */
+void requestPowerOff(void)
+{
+    if (housekeepingTaskHandle)
+        xTaskNotifyGive(housekeepingTaskHandle);
+}
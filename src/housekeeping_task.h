@@ -0,0 +1,16 @@
+/**
+ * @file housekeeping_task.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef HOUSEKEEPING_TASK_H
+#define HOUSEKEEPING_TASK_H
+
+void housekeepingTaskInit(void);
+void requestPowerOff(void);
+
+#endif // HOUSEKEEPING_TASK_H
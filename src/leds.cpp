@@ -8,69 +8,68 @@
  */
 
 #include "leds.h"
+#include "constants.h"
 #include "esp_timer.h"
-#include <map>
 
-// Map to keep track of timers by GPIO pin number
-static std::map<gpio_num_t, esp_timer_handle_t> timers;
+// LEDs that can blink, their timers are created by ledsInit() before any task may blink them
+static const gpio_num_t blinkingLeds[] = {LED_BUTTON_A, LED_BUTTON_B, LED_BUTTON_C};
+static esp_timer_handle_t timers[sizeof(blinkingLeds) / sizeof(blinkingLeds[0])];
 
-// Callback function to turn off the LED
 /**
  * @brief Callback function for the timer.
  *
  * This function is called when the timer expires. It turns off the LED
  * associated with the given GPIO pin.
  *
- * @param arg Pointer to the GPIO pin number (gpio_num_t) associated with the LED.
+ * @param arg The GPIO pin number (gpio_num_t) of the LED cast to a pointer.
  */
 void IRAM_ATTR timerCallback(void *arg)
 {
-    // Cast arg back to gpio_num_t
-    gpio_num_t ledPin = *(gpio_num_t *)arg;
     // Turn off the LED
-    digitalWrite(ledPin, LOW);
+    digitalWrite((gpio_num_t)(uintptr_t)arg, LOW);
+}
+
+/**
+ * @brief Creates the timers turning off the blinking LEDs.
+ *
+ * Must be called before any task calls blinkWithLed(), the timers are never created or
+ * destroyed afterwards, so blinkWithLed() can be called from any task on both cores.
+ */
+void ledsInit(void)
+{
+    for (size_t i = 0; i < sizeof(blinkingLeds) / sizeof(blinkingLeds[0]); i++)
+    {
+        const esp_timer_create_args_t timerArgs = {
+            .callback = &timerCallback,
+            .arg = (void *)(uintptr_t)blinkingLeds[i], // The pin is passed as the argument
+            .name = "ledOffTimer"};
+
+        esp_timer_create(&timerArgs, &timers[i]);
+    }
 }
 
 /**
  * @brief Blinks an LED for a specified duration.
  *
  * This function turns on an LED for a specified duration and then turns it off.
- * It uses a single-shot timer to control the duration of the LED blink.
+ * It uses the single-shot timer of the LED created by ledsInit(), LEDs without a timer are ignored.
  *
  * @param ledPin The GPIO pin number of the LED.
  * @param duration The duration of the LED blink in milliseconds.
  */
 void blinkWithLed(gpio_num_t ledPin, uint32_t duration)
 {
-    // Check if a timer for this pin already exists
-    auto ledTimerIterator = timers.find(ledPin);
-    if (ledTimerIterator != timers.end())
-    {
-        // Timer exists, restart it with the new duration
-        esp_timer_stop(ledTimerIterator->second);
-        esp_timer_start_once(ledTimerIterator->second, duration * 1000);
-    }
-    else
+    for (size_t i = 0; i < sizeof(blinkingLeds) / sizeof(blinkingLeds[0]); i++)
     {
-        // No timer for this pin, create a new one
-        // Allocate memory for the gpio_num_t pointer to pass as an argument to the timer callback
-        gpio_num_t *ledPinPtr = new gpio_num_t(ledPin);
-
-        const esp_timer_create_args_t timerArgs = {
-            .callback = &timerCallback,
-            .arg = ledPinPtr, // Pass the ledPin pointer as an argument
-            .name = "ledOffTimer"};
-
-        esp_timer_handle_t timerHandle;
-        esp_timer_create(&timerArgs, &timerHandle);
+        if (blinkingLeds[i] != ledPin || !timers[i])
+            continue;
 
-        // Add the new timer to the map
-        timers[ledPin] = timerHandle;
+        // Restart the timer with the new duration. Duration is in microseconds
+        esp_timer_stop(timers[i]);
+        esp_timer_start_once(timers[i], duration * 1000);
 
-        // Start the timer. Duration is in microseconds
-        esp_timer_start_once(timerHandle, duration * 1000);
+        // Turn on the LED
+        digitalWrite(ledPin, HIGH);
+        return;
     }
-
-    // Turn on the LED
-    digitalWrite(ledPin, HIGH);
-}
\ No newline at end of file
+}
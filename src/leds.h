@@ -12,6 +12,7 @@
 
 #include <Arduino.h>
 
+void ledsInit(void);
 void blinkWithLed(gpio_num_t ledPin, uint32_t duration = 10);
 
 #endif // LEDS_H
\ No newline at end of file
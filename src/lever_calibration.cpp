@@ -0,0 +1,330 @@
+/**
+ * @file lever_calibration.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "lever_calibration.h"
+
+#include <algorithm>
+#include <Arduino.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+
+#include "lever_config.h"
+#include "logger.h"
+
+// Marker of a valid stored calibration, change it when the layout of the stored data changes
+#define CALIBRATION_MAGIC 0x4C43414C // "LCAL"
+
+// NVS namespace and key of the stored calibration
+#define CALIBRATION_NVS_NAMESPACE "levers"
+#define CALIBRATION_NVS_KEY       "cal"
+
+// Number of frames averaged for the center position when the stored calibration can't be trusted
+#define CALIBRATION_FRAMES 16
+// Maximum difference of the first frame from the stored center to trust the stored calibration
+#define CALIBRATION_QUICK_TOLERANCE 12
+// Maximum spread of the calibration frames for a lever at rest
+#define CALIBRATION_MAX_SPREAD 16
+// Maximum accepted drift of the measured center from the stored one, larger means the lever was nudged
+#define CALIBRATION_MAX_DRIFT 40
+// Maximum distance of a learned limit inside of the configured one, a lever stopped before is not at its end
+#define CALIBRATION_LIMIT_TOLERANCE 50
+// Number of consecutive sampling cycles (5 ms each) the lever must rest at the end stop to learn it
+#define CALIBRATION_HOLD_CYCLES 40
+// Margin subtracted from the learned extremes so the full output is reliably reachable
+#define CALIBRATION_END_MARGIN 5
+
+// Calibration data as stored in RTC memory and NVS
+struct StoredCalibration
+{
+    uint32_t magic;
+    LeverCalibration data;
+    uint8_t learnedMin;  // Bit mask of the levers with a learned minimum
+    uint8_t learnedMax;  // Bit mask of the levers with a learned maximum
+    uint8_t reserved[2]; // Explicit padding, so the checksum covers defined bytes only
+    uint32_t checksum;
+};
+
+// Survives the deep sleep, so waking up doesn't need NVS access
+RTC_DATA_ATTR StoredCalibration rtcCalibration;
+
+StoredCalibration calibration; // Working copy, updated by the sampling task
+bool storedCalibrationValid = false;
+bool calibrationChanged = false;
+uint8_t calibrationFramesCount = 0;
+uint16_t calibrationFrames[CALIBRATION_FRAMES][LEVERS_COUNT];
+uint16_t limitHoldValues[LEVERS_COUNT]; // Averaged value the lever rests at near an end stop
+uint8_t limitHoldCycles[LEVERS_COUNT];  // Number of cycles the lever has rested there
+
+// Guards the working copy while it is being saved from another task
+portMUX_TYPE calibrationMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Calculates the FNV-1a checksum of the stored calibration (without the checksum field).
+ */
+uint32_t calibrationChecksum(const StoredCalibration &stored)
+{
+    const uint8_t *bytes = (const uint8_t *)&stored;
+    uint32_t hash = 2166136261UL;
+
+    for (size_t i = 0; i < offsetof(StoredCalibration, checksum); i++)
+        hash = (hash ^ bytes[i]) * 16777619UL;
+
+    return hash;
+}
+
+bool isCalibrationValid(const StoredCalibration &stored)
+{
+    return stored.magic == CALIBRATION_MAGIC && stored.checksum == calibrationChecksum(stored);
+}
+
+/**
+ * @brief Fills the calibration used by the levers: centers plus learned or configured limits.
+ *
+ * Learned limits far inside of the configured ones (stored by an older firmware) are not applied.
+ */
+void getEffectiveCalibration(LeverCalibration &result)
+{
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        const LeverConfig &config = leverConfigs[i];
+        bool learnedMin = calibration.learnedMin & (1 << i) &&
+                          calibration.data.minAdcVal[i] <= config.minAdcVal + CALIBRATION_LIMIT_TOLERANCE + CALIBRATION_END_MARGIN;
+        bool learnedMax = calibration.learnedMax & (1 << i) &&
+                          calibration.data.maxAdcVal[i] + CALIBRATION_LIMIT_TOLERANCE + CALIBRATION_END_MARGIN >= config.maxAdcVal;
+
+        result.center[i] = calibration.data.center[i];
+        result.minAdcVal[i] = learnedMin ? calibration.data.minAdcVal[i] : config.minAdcVal;
+        result.maxAdcVal[i] = learnedMax ? calibration.data.maxAdcVal[i] : config.maxAdcVal;
+    }
+}
+
+/**
+ * @brief Copies the working calibration to the RTC memory, so it survives the deep sleep.
+ */
+void updateRtcCalibration()
+{
+    portENTER_CRITICAL(&calibrationMux);
+    calibration.magic = CALIBRATION_MAGIC;
+    calibration.checksum = calibrationChecksum(calibration);
+    rtcCalibration = calibration;
+    portEXIT_CRITICAL(&calibrationMux);
+}
+
+/**
+ * @brief Loads the stored calibration from the RTC memory after a wake-up or from NVS after a cold boot.
+ */
+void loadLeverCalibration()
+{
+    calibrationFramesCount = 0;
+
+    if (isCalibrationValid(rtcCalibration))
+    {
+        calibration = rtcCalibration;
+        storedCalibrationValid = true;
+        LOG_INFO("Lever calibration loaded from RTC memory");
+        return;
+    }
+
+    Preferences preferences;
+    preferences.begin(CALIBRATION_NVS_NAMESPACE, true);
+    size_t length = preferences.getBytes(CALIBRATION_NVS_KEY, &calibration, sizeof(calibration));
+    preferences.end();
+
+    storedCalibrationValid = length == sizeof(calibration) && isCalibrationValid(calibration);
+    if (storedCalibrationValid)
+    {
+        LOG_INFO("Lever calibration loaded from NVS");
+    }
+    else
+    {
+        memset(&calibration, 0, sizeof(calibration));
+        LOG_INFO("No stored lever calibration");
+    }
+}
+
+/**
+ * @brief Calibrates the levers frame by frame.
+ *
+ * If the first frame matches the stored calibration, it is used right away. Otherwise the center
+ * positions are averaged over CALIBRATION_FRAMES frames with outliers rejected. A lever that moves
+ * during the calibration or rests far from its stored center keeps the stored center.
+ *
+ * @param frame The next ADC frame.
+ * @param result The calibration to use, valid once the function returns true.
+ * @return True when the calibration is finished.
+ */
+bool calibrateLevers(const AdcFrame &frame, LeverCalibration &result)
+{
+    uint16_t samples[LEVERS_COUNT];
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        samples[i] = frame.samples[adc1Channel(leverConfigs[i].pin)];
+
+    // Quick check: trust the stored calibration if all levers rest at their stored centers
+    if (calibrationFramesCount == 0 && storedCalibrationValid)
+    {
+        bool matches = true;
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+            matches &= abs(samples[i] - calibration.data.center[i]) <= CALIBRATION_QUICK_TOLERANCE;
+
+        if (matches)
+        {
+            getEffectiveCalibration(result);
+            updateRtcCalibration();
+            LOG_INFO("Stored lever calibration verified");
+            return true;
+        }
+    }
+
+    // Collect frames for the full calibration
+    memcpy(calibrationFrames[calibrationFramesCount++], samples, sizeof(samples));
+    if (calibrationFramesCount < CALIBRATION_FRAMES)
+        return false;
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        uint16_t column[CALIBRATION_FRAMES];
+        for (uint8_t j = 0; j < CALIBRATION_FRAMES; j++)
+            column[j] = calibrationFrames[j][i];
+
+        std::sort(column, column + CALIBRATION_FRAMES);
+        uint16_t median = column[CALIBRATION_FRAMES / 2];
+        uint16_t spread = column[CALIBRATION_FRAMES - 1] - column[0];
+
+        // Keep the stored center if the lever was moved or held away from the center during the boot
+        if (storedCalibrationValid && (spread > CALIBRATION_MAX_SPREAD || abs(median - calibration.data.center[i]) > CALIBRATION_MAX_DRIFT))
+        {
+            LOG_WARN("Lever %u is not at rest (median %u, spread %u) - using stored center %u",
+                     i, median, spread, calibration.data.center[i]);
+            continue;
+        }
+
+        // Average the samples close to the median, rejecting outliers
+        uint32_t total = 0;
+        uint8_t count = 0;
+        for (uint8_t j = 0; j < CALIBRATION_FRAMES; j++)
+        {
+            if (abs(column[j] - median) <= CALIBRATION_MAX_SPREAD / 2)
+            {
+                total += column[j];
+                count++;
+            }
+        }
+
+        calibration.data.center[i] = (total + count / 2) / count;
+    }
+
+    calibrationChanged = true;
+    storedCalibrationValid = true;
+    getEffectiveCalibration(result);
+    updateRtcCalibration();
+    LOG_INFO("Levers calibrated");
+
+    return true;
+}
+
+/**
+ * @brief Counts the cycles the lever rests at the same value near an end stop.
+ *
+ * @return True once the lever has rested there for CALIBRATION_HOLD_CYCLES cycles.
+ */
+bool holdLeverLimit(uint8_t lever, uint16_t average, bool nearEndStop)
+{
+    if (!nearEndStop)
+    {
+        limitHoldCycles[lever] = 0;
+        return false;
+    }
+
+    if (limitHoldCycles[lever] == 0 || abs(average - limitHoldValues[lever]) > CALIBRATION_MAX_SPREAD / 2)
+    {
+        limitHoldValues[lever] = average;
+        limitHoldCycles[lever] = 0;
+    }
+
+    if (limitHoldCycles[lever] < CALIBRATION_HOLD_CYCLES)
+        limitHoldCycles[lever]++;
+
+    return limitHoldCycles[lever] == CALIBRATION_HOLD_CYCLES;
+}
+
+/**
+ * @brief Learns the reachable lever limits from the averaged lever values.
+ *
+ * A limit is learned only when the lever rests for CALIBRATION_HOLD_CYCLES cycles beyond or within
+ * CALIBRATION_LIMIT_TOLERANCE of the configured limit, so a partial excursion is never taken for the
+ * end stop. The learned limits are stored and applied with the next calibration.
+ *
+ * @param averages The averaged ADC values of all levers.
+ */
+void learnLeverLimits(const uint16_t *averages)
+{
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        uint8_t mask = 1 << i;
+        bool nearMin = averages[i] <= leverConfigs[i].minAdcVal + CALIBRATION_LIMIT_TOLERANCE;
+        bool nearMax = averages[i] + CALIBRATION_LIMIT_TOLERANCE >= leverConfigs[i].maxAdcVal;
+
+        if (!holdLeverLimit(i, averages[i], nearMin || nearMax))
+            continue;
+
+        if (nearMin)
+        {
+            uint16_t candidate = averages[i] + CALIBRATION_END_MARGIN;
+            if (!(calibration.learnedMin & mask) || candidate < calibration.data.minAdcVal[i])
+            {
+                portENTER_CRITICAL(&calibrationMux);
+                calibration.data.minAdcVal[i] = candidate;
+                calibration.learnedMin |= mask;
+                calibrationChanged = true;
+                portEXIT_CRITICAL(&calibrationMux);
+            }
+        }
+        else
+        {
+            uint16_t candidate = averages[i] - CALIBRATION_END_MARGIN;
+            if (!(calibration.learnedMax & mask) || candidate > calibration.data.maxAdcVal[i])
+            {
+                portENTER_CRITICAL(&calibrationMux);
+                calibration.data.maxAdcVal[i] = candidate;
+                calibration.learnedMax |= mask;
+                calibrationChanged = true;
+                portEXIT_CRITICAL(&calibrationMux);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Stores the calibration to the RTC memory and, if it has changed, to NVS.
+ *
+ * @note Should be called before going to the deep sleep.
+ */
+void saveLeverCalibration()
+{
+    if (!storedCalibrationValid)
+        return;
+
+    updateRtcCalibration();
+
+    if (!calibrationChanged)
+        return;
+
+    Preferences preferences;
+    preferences.begin(CALIBRATION_NVS_NAMESPACE, false);
+    if (preferences.putBytes(CALIBRATION_NVS_KEY, &rtcCalibration, sizeof(rtcCalibration)) == sizeof(rtcCalibration))
+    {
+        calibrationChanged = false;
+        LOG_INFO("Lever calibration saved to NVS");
+    }
+    else
+    {
+        LOG_ERROR("Failed to save lever calibration");
+    }
+    preferences.end();
+}
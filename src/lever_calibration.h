@@ -0,0 +1,31 @@
+/**
+ * @file lever_calibration.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef LEVER_CALIBRATION_H
+#define LEVER_CALIBRATION_H
+
+#include <stdint.h>
+
+#include "adc_sampler.h"
+#include "constants.h"
+
+// Calibration of all levers in the order of the lever configuration table
+struct LeverCalibration
+{
+    uint16_t center[LEVERS_COUNT];    // Center positions
+    uint16_t minAdcVal[LEVERS_COUNT]; // Minimum analog values (learned or from the configuration)
+    uint16_t maxAdcVal[LEVERS_COUNT]; // Maximum analog values (learned or from the configuration)
+};
+
+void loadLeverCalibration(void);
+bool calibrateLevers(const AdcFrame &frame, LeverCalibration &calibration);
+void learnLeverLimits(const uint16_t *averages);
+void saveLeverCalibration(void);
+
+#endif // LEVER_CALIBRATION_H
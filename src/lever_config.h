@@ -0,0 +1,71 @@
+/**
+ * @file lever_config.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef LEVER_CONFIG_H
+#define LEVER_CONFIG_H
+
+#include <stdint.h>
+
+#include "constants.h"
+#include "lever_curves.h"
+#include "lever_filters.h"
+
+// Number of frames in the moving average (must be a power of two)
+#define LEVER_FILTER_WINDOW 8
+
+// Parameters of the adaptive filters (values are in 10-bit ADC counts, speeds in counts per second)
+constexpr OneEuroParams leverOneEuroParams = {1.5f, 0.02f, 1.0f};
+constexpr KalmanParams leverKalmanParams = {0.05f, 14.0f, 0.05f, 2.0f};
+
+// Output range of the lever positions (-LEVER_OUTPUT_MAX to LEVER_OUTPUT_MAX)
+#define LEVER_OUTPUT_MAX 1023
+
+struct LeverConfig
+{
+    uint8_t pin;        // Analog input pin (ADC1 only)
+    uint16_t minAdcVal; // Minimum expected analog value
+    uint16_t maxAdcVal; // Maximum expected analog value
+    bool invert;        // Invert the lever value
+    uint16_t deadZone;  // Dead zone around the center position
+    LeverCurve curve;   // Response curve applied to the output
+    LeverFilter filter; // Noise filter applied to the ADC samples
+    uint8_t quantum;    // Output step, positions are rounded towards zero to multiples of it (1 - off)
+    uint8_t hysteresis; // Output changes up to this value are not reported as movement (0 - off)
+};
+
+/*
+ * Configuration of all levers in the order they are sent to the Excavator:
+ * 0 - Boom, 1 - Bucket, 2 - Stick, 3 - Swing, 4 - Left Travel, 5 - Right Travel
+ */
+constexpr LeverConfig leverConfigs[LEVERS_COUNT] = {
+    {BOOM_LEVER, 10, 1010, true, 60, LEVER_CURVE_LINEAR, LEVER_FILTER_ONE_EURO, 4, 4},
+    {BUCKET_LEVER, 65, 1010, true, 70, LEVER_CURVE_LINEAR, LEVER_FILTER_ONE_EURO, 4, 4},
+    {STICK_LEVER, 10, 900, true, 40, LEVER_CURVE_LINEAR, LEVER_FILTER_AVERAGE, 4, 4},
+    {SWING_LEVER, 10, 930, false, 40, LEVER_CURVE_LINEAR, LEVER_FILTER_AVERAGE, 4, 4},
+    {LEFT_TRAVEL_LEVER, 10, 1010, true, 40, LEVER_CURVE_LINEAR, LEVER_FILTER_AVERAGE, 8, 8},
+    {RIGHT_TRAVEL_LEVER, 10, 1010, true, 40, LEVER_CURVE_LINEAR, LEVER_FILTER_AVERAGE, 8, 8}};
+
+/**
+ * @brief Checks the lever configuration at compile time.
+ */
+constexpr bool leverConfigsValid()
+{
+    for (const LeverConfig &config : leverConfigs)
+    {
+        if (config.minAdcVal >= config.maxAdcVal || config.maxAdcVal > LEVER_CURVE_MAX || config.curve >= LEVER_CURVES_COUNT ||
+            config.filter >= LEVER_FILTERS_COUNT || config.quantum == 0)
+            return false;
+    }
+    return true;
+}
+
+static_assert(leverConfigsValid(), "Invalid lever configuration");
+static_assert((LEVER_FILTER_WINDOW & (LEVER_FILTER_WINDOW - 1)) == 0, "LEVER_FILTER_WINDOW must be a power of two");
+
+#endif // LEVER_CONFIG_H
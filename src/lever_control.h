@@ -10,77 +10,302 @@
 #ifndef LEVER_CONTROL_H
 #define LEVER_CONTROL_H
 
-#include <Arduino.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
 
-class Lever
+#include "adc_sampler.h"
+#include "lever_calibration.h"
+#include "lever_config.h"
+#include "lever_curves.h"
+#include "lever_filters.h"
+
+// Divisions by the calibrated spans are done as multiplications by their reciprocals, the result equals
+// the integer division for numerators up to 2^31 / LEVER_CURVE_SIZE (the output scaling needs 2^20)
+#define LEVER_RECIPROCAL_SHIFT 31
+
+static_assert(LEVER_OUTPUT_MAX == LEVER_CURVE_MAX, "The response curves are indexed by the output magnitude");
+
+/**
+ * @brief Returns the reciprocal of the divisor (1 to LEVER_CURVE_SIZE) for leverDivide().
+ */
+constexpr uint32_t leverReciprocal(uint32_t divisor)
+{
+    return ((1ULL << LEVER_RECIPROCAL_SHIFT) + divisor - 1) / divisor;
+}
+
+/**
+ * @brief Divides by the divisor of the reciprocal, rounding down like the integer division.
+ */
+inline uint32_t leverDivide(uint32_t numerator, uint32_t reciprocal)
+{
+    return (uint64_t)numerator * reciprocal >> LEVER_RECIPROCAL_SHIFT;
+}
+
+/**
+ * @brief Response of a lever with the calibration folded in, prepared once by makeLeverMapping().
+ *
+ * The dead zone is folded into the edges of both sides, the output scaling into the reciprocals of
+ * their spans and the inversion into the sign, so a position is a multiplication and a shift, the
+ * curve lookup and the quantization. A side without any travel (the center at its end) gives the
+ * full output outside of the dead zone.
+ */
+struct LeverMapping
+{
+    const uint16_t *curve;  // Response curve table in flash
+    uint32_t lowerScale;    // Reciprocal of the span from the minimum to the lower edge
+    uint32_t upperScale;    // Reciprocal of the span from the upper edge to the maximum
+    uint32_t quantumScale;  // Reciprocal of the output step
+    int16_t lowerMin;       // Calibrated minimum analog value, full output of the lower side
+    int16_t lowerEdge;      // Values below this edge are on the lower side
+    int16_t upperEdge;      // Values from this edge on are on the upper side
+    uint8_t quantum;        // Output step, positions are rounded towards zero to multiples of it
+    bool lowerPositive;     // The lower side gives positive positions (inverted lever)
+};
+
+/**
+ * @brief Folds the calibration of a lever into its response mapping.
+ *
+ * @param config The lever configuration.
+ * @param zeroPos The calibrated center position of the lever.
+ * @param minAdcVal The minimum analog value of the lever.
+ * @param maxAdcVal The maximum analog value of the lever.
+ */
+LeverMapping makeLeverMapping(const LeverConfig &config, uint16_t zeroPos, uint16_t minAdcVal, uint16_t maxAdcVal);
+
+/**
+ * @brief Calculates the output position of a lever from the averaged ADC value using integer math only.
+ *
+ * Gives the same positions as mapping the value with the Arduino map() between the calibrated limits
+ * and the dead zone, followed by the response curve, quantization and inversion.
+ *
+ * @param mapping The response mapping of the lever.
+ * @param adcVal The averaged ADC value in the range of 0 to LEVER_CURVE_MAX.
+ * @return The output position in the range of -LEVER_OUTPUT_MAX to LEVER_OUTPUT_MAX.
+ */
+inline int16_t leverResponse(const LeverMapping &mapping, int32_t adcVal)
+{
+    uint32_t magnitude;
+    bool positive;
+
+    if (adcVal >= mapping.upperEdge)
+    {
+        magnitude = leverDivide((adcVal - mapping.upperEdge) * LEVER_OUTPUT_MAX, mapping.upperScale);
+        magnitude = std::min<uint32_t>(magnitude, LEVER_OUTPUT_MAX);
+        positive = !mapping.lowerPositive;
+    }
+    else if (adcVal < mapping.lowerEdge)
+    {
+        uint32_t travel = std::max<int32_t>(adcVal - mapping.lowerMin, 0);
+        magnitude = LEVER_OUTPUT_MAX - leverDivide(travel * LEVER_OUTPUT_MAX, mapping.lowerScale);
+        positive = mapping.lowerPositive;
+    }
+    else
+    {
+        return 0; // Within dead-zone
+    }
+
+    // Shape the magnitude with the response curve, then quantize towards zero keeping the full output
+    magnitude = mapping.curve[magnitude];
+    if (magnitude < LEVER_OUTPUT_MAX)
+        magnitude = leverDivide(magnitude, mapping.quantumScale) * mapping.quantum;
+
+    return positive ? (int16_t)magnitude : -(int16_t)magnitude;
+}
+
+/**
+ * @brief Bank of levers filtered and mapped together in a single pass.
+ *
+ * The filter state of all levers is kept in contiguous arrays, the moving average window is
+ * a power of two known at compile time, so the average is a shift. Every lever can use its own
+ * filter (moving average, One-Euro or Kalman) selected in the configuration table. Position changes
+ * within the hysteresis of the lever are suppressed, except returning to zero and reaching full scale.
+ * The calibration is folded into a response mapping per lever, the response curves are read from the
+ * shared tables in flash, so a lever needs no table in RAM.
+ *
+ * @tparam N Number of levers.
+ * @tparam Window Number of frames in the moving average (power of two).
+ */
+template <size_t N, size_t Window>
+class LeverBank
 {
+    static_assert(Window >= 1 && (Window & (Window - 1)) == 0, "LeverBank window must be a power of two");
+
 private:
-    uint8_t pin;
-    uint16_t minAdcVal;        // Minimum expected analog value
-    uint16_t maxAdcVal;        // Maximum expected analog value
-    uint16_t zeroPos;          // Center position of the lever
-    uint16_t deadZone;         // Dead zone value
-    bool invert;               // Invert the lever value
-    bool exponentialSmoothing; // Use exponential smoothing
-    int16_t pos;               // Current lever calculated position
-    int16_t lastPos;           // Last lever calculated position
-    uint16_t rawValue;         // Current lever raw value
-    int16_t minOutput;         // Minimum output value
-    int16_t maxOutput;         // Maximum output value
-    uint16_t updateInterval;   // Period between readings in milliseconds
-    uint32_t lastUpdateTime;   // Last reading time in milliseconds
-
-    uint8_t numReadings = 10; // Number of readings to average
-    uint16_t readings[10];    // Readings buffer (size must be the same as numReadings)
-    uint8_t readIndex = 0;    // Index of the current reading
-    uint32_t total = 0;       // Running total
-    int16_t calcRes = 0;      // Calculated result
+    static constexpr uint8_t windowShift = __builtin_ctz(Window);
 
-    /**
-     * @brief Reads the lever input and filters the readings using a moving average algorithm and exponential smoothing.
-     * @return The filtered lever value.
-     */
-    int16_t readAndFilter();
+    const LeverConfig *configs;
+    uint8_t channels[N];                   // ADC1 channels of the levers, indexes of the samples in the frame
+    LeverFilter filters[N];                // Filters of the levers, copied out of the table read every tick
+    uint8_t hysteresis[N];                 // Hysteresis of the levers, copied out of the table read every tick
+    uint16_t zeroPos[N] = {};              // Center positions of the levers
+    uint16_t rawValues[N] = {};            // Last raw ADC values
+    int16_t positions[N] = {};             // Current calculated positions
+    uint32_t totals[N] = {};               // Running totals of the moving average
+    uint16_t readings[Window][N] = {};     // Readings buffer, one row of all levers per frame
+    uint8_t readIndex = 0;                 // Index of the current row
+    LeverFilterState filterStates[N] = {}; // State of the adaptive filters
+    uint32_t lastFrameUs = 0;              // Timestamp of the previous frame in microseconds
+    bool adaptiveFilters = false;          // Any lever uses a filter depending on the time step
+    uint32_t emittedUpdates = 0;           // Position changes reported as movement
+    uint32_t suppressedUpdates = 0;        // Position changes suppressed by the hysteresis
+    LeverMapping mappings[N] = {};         // Responses with the calibration folded in
 
 public:
     /**
-     * @brief Construct a new Lever object.
+     * @brief Construct a new LeverBank object.
+     * @param leverConfigs The configuration table with N entries.
      */
-    Lever(uint8_t _pin,
-          uint16_t _minAdcVal = 0,
-          uint16_t _maxAdcVal = 1023,
-          bool _invert = false,
-          uint16_t _deadZone = 40,
-          bool _exponentialSmoothing = false);
+    explicit LeverBank(const LeverConfig *leverConfigs) : configs(leverConfigs)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            channels[i] = adc1Channel(configs[i].pin);
+            filters[i] = configs[i].filter;
+            hysteresis[i] = configs[i].hysteresis;
+            adaptiveFilters |= configs[i].filter != LEVER_FILTER_AVERAGE;
+        }
+    }
 
     /**
-     * @brief Calibrates the lever by reading the center position.
+     * @brief Applies the calibration to all levers.
      */
-    void calibrate();
+    void calibrate(const LeverCalibration &calibration)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            zeroPos[i] = calibration.center[i];
+            mappings[i] = makeLeverMapping(configs[i], zeroPos[i], calibration.minAdcVal[i], calibration.maxAdcVal[i]);
+            rawValues[i] = zeroPos[i];
+            positions[i] = 0;
+
+            // Fill the readings buffer with the current value
+            for (size_t j = 0; j < Window; j++)
+                readings[j][i] = zeroPos[i];
+            totals[i] = (uint32_t)zeroPos[i] * Window;
+            resetLeverFilter(filterStates[i], zeroPos[i],
+                             configs[i].filter == LEVER_FILTER_KALMAN ? leverKalmanParams.measurementNoise : 0.0f);
+        }
+    }
 
     /**
-     * @brief Updates the lever value by reading and filtering the input.
-     * @return True if position has changed, false otherwise.
+     * @brief Updates all levers from the ADC frame.
+     * @return True if any lever position has changed, false otherwise.
      */
-    bool update();
+    bool update(const AdcFrame &frame)
+    {
+        uint16_t *row = readings[readIndex];
+        bool changed = false;
+
+        // Time step for the adaptive filters, nominal frame interval for the first frame
+        float dt = ADC_FRAME_INTERVAL_MS / 1000.0f;
+        if (adaptiveFilters)
+        {
+            if (lastFrameUs && frame.timestampUs != lastFrameUs)
+                dt = (frame.timestampUs - lastFrameUs) / 1000000.0f;
+            lastFrameUs = frame.timestampUs;
+        }
+
+        for (size_t i = 0; i < N; i++)
+        {
+            uint16_t sample = frame.samples[channels[i]];
+
+            // Replace the oldest reading in the running total
+            totals[i] += sample - row[i];
+            row[i] = sample;
+            rawValues[i] = sample;
+
+            uint32_t filtered;
+            switch (filters[i])
+            {
+                case LEVER_FILTER_ONE_EURO:
+                    filtered = oneEuroFilter(filterStates[i], sample, dt, leverOneEuroParams) + 0.5f;
+                    break;
+                case LEVER_FILTER_KALMAN:
+                    filtered = kalmanFilter(filterStates[i], sample, leverKalmanParams) + 0.5f;
+                    break;
+                default:
+                    filtered = totals[i] >> windowShift;
+                    break;
+            }
+
+            int16_t pos = leverResponse(mappings[i], std::min<uint32_t>(filtered, LEVER_CURVE_MAX));
+            if (pos == positions[i])
+                continue;
+
+            // Report only meaningful changes, but never hold back the neutral or the full position
+            if (abs(pos - positions[i]) > hysteresis[i] || pos == 0 || abs(pos) == LEVER_OUTPUT_MAX)
+            {
+                positions[i] = pos;
+                emittedUpdates++;
+                changed = true;
+            }
+            else
+            {
+                suppressedUpdates++;
+            }
+        }
+
+        readIndex = (readIndex + 1) & (Window - 1);
+
+        return changed;
+    }
 
     /**
-     * @brief Returns the calculated, mapped and filtered lever position.
-     * @return The current lever position.
+     * @brief Returns the calculated, mapped and filtered position of the lever.
      */
-    int16_t position() const;
+    int16_t position(size_t index) const
+    {
+        return positions[index];
+    }
 
     /**
      * @brief Returns last raw ADC value of the lever.
-     * @return The raw value of the lever.
      */
-    uint16_t value() const;
+    uint16_t value(size_t index) const
+    {
+        return rawValues[index];
+    }
+
+    /**
+     * @brief Returns the number of position changes reported as movement.
+     */
+    uint32_t emittedCount() const
+    {
+        return emittedUpdates;
+    }
+
+    /**
+     * @brief Returns the number of position changes suppressed by the hysteresis.
+     */
+    uint32_t suppressedCount() const
+    {
+        return suppressedUpdates;
+    }
+
+    /**
+     * @brief Returns the moving average of the lever ADC values.
+     */
+    uint16_t average(size_t index) const
+    {
+        return totals[index] >> windowShift;
+    }
+
+    /**
+     * @brief Returns the calibrated center position of the lever.
+     */
+    uint16_t center(size_t index) const
+    {
+        return zeroPos[index];
+    }
 
     /**
-     * @brief Returns a string with the lever debug information.
-     * @return A string with the lever debug information.
+     * @brief Returns the analog pin of the lever.
      */
-    String printDebug();
+    uint8_t getPin(size_t index) const
+    {
+        return configs[index].pin;
+    }
 };
 
-#endif // LEVER_CONTROL_H
\ No newline at end of file
+#endif // LEVER_CONTROL_H
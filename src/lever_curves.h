@@ -0,0 +1,98 @@
+/**
+ * @file lever_curves.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef LEVER_CURVES_H
+#define LEVER_CURVES_H
+
+#include <stdint.h>
+#include <array>
+
+// Number of entries in the response curve tables (matches the 10-bit ADC range)
+#define LEVER_CURVE_SIZE 1024
+// Maximum input and output magnitude of the response curves
+#define LEVER_CURVE_MAX (LEVER_CURVE_SIZE - 1)
+
+// Share of the cubic component in the expo curve in percent (0 - linear, 100 - cubic)
+#define LEVER_CURVE_EXPO_PERCENT 50
+
+// Control points of the custom curve, evenly spaced over the input range (piecewise linear in between)
+#define LEVER_CURVE_CUSTOM_POINTS {0, 60, 160, 300, 480, 720, 1023}
+
+enum LeverCurve : uint8_t
+{
+    LEVER_CURVE_LINEAR, // Output follows the lever linearly
+    LEVER_CURVE_EXPO,   // Mix of linear and cubic for finer control around the center
+    LEVER_CURVE_CUBIC,  // Same as the former exponential smoothing: x^3 / max^2
+    LEVER_CURVE_CUSTOM, // Piecewise linear curve defined by LEVER_CURVE_CUSTOM_POINTS
+    LEVER_CURVES_COUNT
+};
+
+using LeverCurveTable = std::array<uint16_t, LEVER_CURVE_SIZE>;
+
+/**
+ * @brief Evaluates the response curve for a single input magnitude using integer math only.
+ *
+ * @param curve The response curve type.
+ * @param x The input magnitude in the range of 0 to LEVER_CURVE_MAX.
+ * @return The shaped output magnitude in the range of 0 to LEVER_CURVE_MAX.
+ */
+constexpr uint16_t leverCurvePoint(LeverCurve curve, uint32_t x)
+{
+    constexpr uint64_t maxSquared = (uint64_t)LEVER_CURVE_MAX * LEVER_CURVE_MAX;
+
+    switch (curve)
+    {
+        case LEVER_CURVE_EXPO:
+        {
+            uint64_t cubic = (uint64_t)x * x * x / maxSquared;
+            return (x * (100 - LEVER_CURVE_EXPO_PERCENT) + cubic * LEVER_CURVE_EXPO_PERCENT) / 100;
+        }
+        case LEVER_CURVE_CUBIC:
+            return (uint64_t)x * x * x / maxSquared;
+        case LEVER_CURVE_CUSTOM:
+        {
+            constexpr uint16_t points[] = LEVER_CURVE_CUSTOM_POINTS;
+            constexpr uint32_t segments = sizeof(points) / sizeof(points[0]) - 1;
+            if (x >= LEVER_CURVE_MAX)
+                return points[segments];
+            // Locate the segment and interpolate between its control points
+            uint32_t scaled = x * segments;
+            uint32_t segment = scaled / LEVER_CURVE_MAX;
+            uint32_t offset = scaled % LEVER_CURVE_MAX;
+            return points[segment] + (int32_t)(points[segment + 1] - points[segment]) * (int32_t)offset / LEVER_CURVE_MAX;
+        }
+        default:
+            return x;
+    }
+}
+
+/**
+ * @brief Generates the whole response curve table at compile time.
+ */
+constexpr LeverCurveTable makeLeverCurveTable(LeverCurve curve)
+{
+    LeverCurveTable table{};
+    for (uint32_t i = 0; i < LEVER_CURVE_SIZE; i++)
+        table[i] = leverCurvePoint(curve, i);
+    return table;
+}
+
+// Response curve tables generated by the compiler and stored in flash
+inline constexpr std::array<LeverCurveTable, LEVER_CURVES_COUNT> leverCurveTables = {
+    makeLeverCurveTable(LEVER_CURVE_LINEAR),
+    makeLeverCurveTable(LEVER_CURVE_EXPO),
+    makeLeverCurveTable(LEVER_CURVE_CUBIC),
+    makeLeverCurveTable(LEVER_CURVE_CUSTOM)};
+
+static_assert(leverCurveTables[LEVER_CURVE_LINEAR][LEVER_CURVE_MAX] == LEVER_CURVE_MAX, "Linear curve must reach full scale");
+static_assert(leverCurveTables[LEVER_CURVE_EXPO][LEVER_CURVE_MAX] == LEVER_CURVE_MAX, "Expo curve must reach full scale");
+static_assert(leverCurveTables[LEVER_CURVE_CUBIC][LEVER_CURVE_MAX] == LEVER_CURVE_MAX, "Cubic curve must reach full scale");
+static_assert(leverCurveTables[LEVER_CURVE_CUSTOM][LEVER_CURVE_MAX] == LEVER_CURVE_MAX, "Custom curve must reach full scale");
+
+#endif // LEVER_CURVES_H
@@ -0,0 +1,116 @@
+/**
+ * @file lever_filters.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef LEVER_FILTERS_H
+#define LEVER_FILTERS_H
+
+#include <stdint.h>
+#include <math.h>
+
+enum LeverFilter : uint8_t
+{
+    LEVER_FILTER_AVERAGE,  // Moving average over LEVER_FILTER_WINDOW frames - smooth, but fixed group delay
+    LEVER_FILTER_ONE_EURO, // One-Euro filter - cutoff frequency rises with the lever speed
+    LEVER_FILTER_KALMAN,   // 1-D Kalman filter with process noise adapted to the innovation
+    LEVER_FILTERS_COUNT
+};
+
+// State of an adaptive filter of one lever
+struct LeverFilterState
+{
+    float value; // Filtered value in ADC counts
+    float aux;   // Filtered derivative (One-Euro) or error covariance (Kalman)
+};
+
+struct OneEuroParams
+{
+    float minCutoffHz;        // Cutoff frequency at rest - lower means less jitter
+    float beta;               // Cutoff increase per count/s of lever speed - higher means less lag
+    float derivativeCutoffHz; // Cutoff frequency of the speed estimation
+};
+
+struct KalmanParams
+{
+    float processNoise;     // Expected variance of the lever movement per frame at rest
+    float measurementNoise; // Variance of the ADC noise
+    float adaptation;       // Share of the squared innovation added to the process noise
+    float adaptationGate;   // Innovation in standard deviations above which the process noise is adapted
+};
+
+/**
+ * @brief Returns the smoothing factor of a first order low-pass filter.
+ */
+inline float lowPassAlpha(float cutoffHz, float dt)
+{
+    float tau = 1.0f / (2.0f * (float)M_PI * cutoffHz);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+/**
+ * @brief Resets the filter state to the given value.
+ */
+inline void resetLeverFilter(LeverFilterState &state, float value, float initialAux)
+{
+    state.value = value;
+    state.aux = initialAux;
+}
+
+/**
+ * @brief One-Euro filter step (Casiez et al., CHI 2012).
+ *
+ * @param state The filter state.
+ * @param sample The new sample in ADC counts.
+ * @param dt Time since the previous sample in seconds.
+ * @param params The filter parameters.
+ * @return The filtered value.
+ */
+inline float oneEuroFilter(LeverFilterState &state, float sample, float dt, const OneEuroParams &params)
+{
+    // Estimate the speed of the lever and smooth it
+    float derivative = (sample - state.value) / dt;
+    state.aux += lowPassAlpha(params.derivativeCutoffHz, dt) * (derivative - state.aux);
+
+    // The faster the lever moves, the higher the cutoff frequency and the lower the lag
+    float cutoffHz = params.minCutoffHz + params.beta * fabsf(state.aux);
+    state.value += lowPassAlpha(cutoffHz, dt) * (sample - state.value);
+
+    return state.value;
+}
+
+/**
+ * @brief 1-D Kalman filter step with a constant position model.
+ *
+ * The process noise grows with the squared innovation, so the gain rises as soon as the lever
+ * starts moving and falls back when it rests. Innovations explained by the ADC noise don't adapt
+ * it, otherwise the noise itself would raise the gain at rest.
+ *
+ * @param state The filter state.
+ * @param sample The new sample in ADC counts.
+ * @param params The filter parameters.
+ * @return The filtered value.
+ */
+inline float kalmanFilter(LeverFilterState &state, float sample, const KalmanParams &params)
+{
+    float innovation = sample - state.value;
+
+    // Predict, adapting only to the innovations well above the expected spread
+    float squaredInnovation = innovation * innovation;
+    state.aux += params.processNoise;
+    if (squaredInnovation > params.adaptationGate * params.adaptationGate * (state.aux + params.measurementNoise))
+        state.aux += params.adaptation * squaredInnovation;
+
+    // Update
+    float gain = state.aux / (state.aux + params.measurementNoise);
+    state.value += gain * innovation;
+    state.aux *= 1.0f - gain;
+
+    return state.value;
+}
+
+#endif // LEVER_FILTERS_H
@@ -0,0 +1,51 @@
+/**
+ * @file link_rate.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "link_rate.h"
+
+#include "constants.h"
+#include "link_rate_controller.h"
+#include "seqlock.h"
+
+// Written only by the radio task
+static LinkRateController controller(SEND_DATA_MIN_INTERVAL);
+static volatile uint32_t sendIntervalMs = SEND_DATA_MIN_INTERVAL;
+
+static SeqLock<LinkRateState> publishedState;
+
+/**
+ * @brief Updates the send rate with the delivery status of a frame (called only from the radio task).
+ *
+ * @param delivered True if the Excavator acknowledged the frame.
+ * @param latencyUs Time from passing the frame to the transport to the send callback in microseconds.
+ * @param userActive True if the frame carried user input, false for keepalive frames.
+ */
+void linkRateReport(bool delivered, uint32_t latencyUs, bool userActive)
+{
+    controller.report(delivered, latencyUs, userActive);
+
+    sendIntervalMs = controller.getState().intervalMs;
+    publishedState.write(controller.getState());
+}
+
+/**
+ * @brief Returns the minimum interval between frames with user input in milliseconds.
+ */
+uint32_t getSendInterval(void)
+{
+    return sendIntervalMs;
+}
+
+/**
+ * @brief Returns a consistent copy of the send rate controller state.
+ */
+LinkRateState getLinkRateState(void)
+{
+    return publishedState.read();
+}
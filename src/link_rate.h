@@ -0,0 +1,51 @@
+/**
+ * @file link_rate.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef LINK_RATE_H
+#define LINK_RATE_H
+
+#include <stdint.h>
+
+// Bounds of the adaptive send interval in milliseconds
+#define LINK_RATE_FASTEST_INTERVAL 10
+#define LINK_RATE_SLOWEST_INTERVAL 200
+
+// Success ratio (in per mille) and MAC latency (in percent of the interval) needed to shorten the interval
+#define LINK_RATE_CLEAN_SUCCESS_PERMILLE 950
+#define LINK_RATE_CLEAN_LATENCY_PERCENT  50
+
+// Number of frames with user input evaluated together before the interval is changed
+#define LINK_RATE_WINDOW_FRAMES 10
+// Failure ratio of a window (in per mille) above which the interval is doubled
+#define LINK_RATE_BACKOFF_FAILURE_PERMILLE 250
+// Consecutive failed frames with user input that double the interval without waiting for the window
+#define LINK_RATE_BURST_FAILURES 4
+// Part of the interval removed after a clean window (1 / LINK_RATE_SPEEDUP_DIVISOR, at least 1 ms)
+#define LINK_RATE_SPEEDUP_DIVISOR 4
+
+// Weight of a new sample in the success ratio and latency averages (1 / LINK_RATE_EWMA_DIVISOR)
+#define LINK_RATE_EWMA_DIVISOR 8
+
+// State of the send rate controller
+struct LinkRateState
+{
+    uint32_t intervalMs;      // Current minimum interval between frames with user input
+    uint32_t successPermille; // Average delivery success ratio in per mille
+    uint32_t avgLatencyUs;    // Average time from esp_now_send() to the send callback in microseconds
+    uint32_t delivered;       // Number of frames acknowledged by the Excavator
+    uint32_t failed;          // Number of frames not acknowledged or timed out
+    uint32_t speedUps;        // Number of interval decreases
+    uint32_t backOffs;        // Number of interval increases
+};
+
+void linkRateReport(bool delivered, uint32_t latencyUs, bool userActive);
+uint32_t getSendInterval(void);
+LinkRateState getLinkRateState(void);
+
+#endif // LINK_RATE_H
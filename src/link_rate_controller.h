@@ -0,0 +1,130 @@
+/**
+ * @file link_rate_controller.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef LINK_RATE_CONTROLLER_H
+#define LINK_RATE_CONTROLLER_H
+
+#include <stdint.h>
+#include <algorithm>
+
+#include "link_rate.h"
+
+/**
+ * @brief Adapts the send interval to the delivery status and the MAC latency of the frames.
+ *
+ * The frames with user input are evaluated in windows of LINK_RATE_WINDOW_FRAMES. The interval is
+ * doubled when more than LINK_RATE_BACKOFF_FAILURE_PERMILLE of a window failed, or right away after
+ * LINK_RATE_BURST_FAILURES failures in a row, so a single lost frame doesn't slow down the link. A
+ * window without failures and with a low MAC latency shortens the interval by a quarter. Keepalive
+ * frames only update the averages and the counters, an idle controller neither backs off nor probes
+ * for a faster rate.
+ *
+ * Has no dependency on the ESP32, so the rate policy can be tested on a development machine.
+ */
+class LinkRateController
+{
+private:
+    LinkRateState state;
+    uint8_t windowFrames = 0;   // Frames with user input in the current window
+    uint8_t windowFailures = 0; // Failed frames with user input in the current window
+    uint8_t failureStreak = 0;  // Consecutive failed frames with user input
+
+    void startWindow()
+    {
+        windowFrames = 0;
+        windowFailures = 0;
+    }
+
+    void backOff()
+    {
+        if (state.intervalMs < LINK_RATE_SLOWEST_INTERVAL)
+        {
+            state.intervalMs = std::min<uint32_t>(state.intervalMs * 2, LINK_RATE_SLOWEST_INTERVAL);
+            state.backOffs++;
+        }
+        startWindow();
+    }
+
+    void speedUp()
+    {
+        if (state.intervalMs > LINK_RATE_FASTEST_INTERVAL)
+        {
+            uint32_t step = std::max<uint32_t>(state.intervalMs / LINK_RATE_SPEEDUP_DIVISOR, 1);
+            state.intervalMs = std::max<uint32_t>(state.intervalMs - step, LINK_RATE_FASTEST_INTERVAL);
+            state.speedUps++;
+        }
+        startWindow();
+    }
+
+public:
+    explicit LinkRateController(uint32_t intervalMs) : state{intervalMs, 1000, 0, 0, 0, 0, 0}
+    {
+    }
+
+    /**
+     * @brief Updates the send rate with the delivery status of a frame.
+     *
+     * @param delivered True if the Excavator acknowledged the frame.
+     * @param latencyUs Time from passing the frame to the transport to the send callback in microseconds.
+     * @param userActive True if the frame carried user input, false for keepalive frames.
+     */
+    void report(bool delivered, uint32_t latencyUs, bool userActive)
+    {
+        int32_t success = delivered ? 1000 : 0;
+        state.successPermille += (success - (int32_t)state.successPermille) / LINK_RATE_EWMA_DIVISOR;
+        state.avgLatencyUs += ((int32_t)latencyUs - (int32_t)state.avgLatencyUs) / LINK_RATE_EWMA_DIVISOR;
+
+        if (delivered)
+            state.delivered++;
+        else
+            state.failed++;
+
+        if (!userActive)
+            return;
+
+        windowFrames++;
+        if (delivered)
+        {
+            failureStreak = 0;
+        }
+        else
+        {
+            windowFailures++;
+            failureStreak++;
+        }
+
+        if (failureStreak >= LINK_RATE_BURST_FAILURES)
+        {
+            failureStreak = 0;
+            backOff();
+            return;
+        }
+
+        if (windowFrames < LINK_RATE_WINDOW_FRAMES)
+            return;
+
+        bool clean = (uint32_t)(windowFrames - windowFailures) * 1000 >=
+                         (uint32_t)windowFrames * LINK_RATE_CLEAN_SUCCESS_PERMILLE &&
+                     state.avgLatencyUs * 100 < state.intervalMs * 1000 * LINK_RATE_CLEAN_LATENCY_PERCENT;
+
+        if ((uint32_t)windowFailures * 1000 > (uint32_t)windowFrames * LINK_RATE_BACKOFF_FAILURE_PERMILLE)
+            backOff();
+        else if (clean)
+            speedUp();
+        else
+            startWindow();
+    }
+
+    const LinkRateState &getState() const
+    {
+        return state;
+    }
+};
+
+#endif // LINK_RATE_CONTROLLER_H
@@ -0,0 +1,179 @@
+/**
+ * @file logger.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "logger.h"
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "mpsc_ring.h"
+
+// Task parameters
+#define LOGGER_TASK_STACK_SIZE (4 * 1024U)
+#define LOGGER_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+#define LOGGER_TASK_CORE       1 // Core 0 is used by the WiFi
+
+// Period of draining the buffered records in milliseconds
+#define LOG_DRAIN_INTERVAL_MS 10
+
+// Longest printed line, longer lines are truncated
+#define LOG_LINE_SIZE 192
+
+struct LogRecord
+{
+    uint32_t timestampMs; // Time the record was written in milliseconds
+    const char *format;   // Format string of a deferred record, NULL for a formatted one
+    uint8_t level;
+    union
+    {
+        uintptr_t args[LOG_MAX_ARGS]; // Raw arguments of a deferred record
+        char text[LOG_TEXT_SIZE];    // Text of a formatted record
+    };
+};
+
+static MpscRing<LogRecord, LOG_BUFFER_SIZE> records;
+
+// Guards the consumer side, records are drained by the logger task and by logFlush()
+static SemaphoreHandle_t drainMutex = NULL;
+static uint32_t reportedDrops = 0;
+
+static const char levelLetters[] = {'-', 'E', 'W', 'I', 'D'};
+
+/**
+ * @brief Stores a deferred record, safe in any context.
+ *
+ * @param level The LOG_LEVEL_* of the record.
+ * @param format The format string, must stay valid until the record is printed.
+ * @param args The raw argument values.
+ * @param count The number of the arguments.
+ */
+void logWrite(uint8_t level, const char *format, const uintptr_t *args, uint8_t count)
+{
+    LogRecord record;
+    record.timestampMs = esp_timer_get_time() / 1000;
+    record.format = format;
+    record.level = level;
+    memcpy(record.args, args, count * sizeof(uintptr_t));
+
+    records.push(record);
+}
+
+/**
+ * @brief Formats the text immediately and stores it as a record, not for ISRs.
+ */
+void logFormatted(uint8_t level, const char *format, ...)
+{
+    LogRecord record;
+    record.timestampMs = esp_timer_get_time() / 1000;
+    record.format = NULL;
+    record.level = level;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+
+    records.push(record);
+}
+
+/**
+ * @brief Formats and prints all buffered records.
+ */
+static void drainRecords()
+{
+    static char line[LOG_LINE_SIZE];
+    LogRecord record;
+
+    while (records.pop(record))
+    {
+        const char *text = record.text;
+        if (record.format)
+        {
+            // Unused arguments are ignored by the formatting
+            const uintptr_t *a = record.args;
+            snprintf(line, sizeof(line), record.format, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+                     a[8], a[9], a[10], a[11]);
+            text = line;
+        }
+
+        Serial.printf("%5u.%03u %c %s\n", record.timestampMs / 1000, record.timestampMs % 1000,
+                      levelLetters[record.level < sizeof(levelLetters) ? record.level : 0], text);
+    }
+
+    // Report the records dropped since the last drain
+    uint32_t dropped = records.overrunCount();
+    if (dropped != reportedDrops)
+    {
+        Serial.printf("%u log records dropped\n", dropped - reportedDrops);
+        reportedDrops = dropped;
+    }
+}
+
+/**
+ * @brief Prints all buffered records before returning, e.g. before going to deep sleep.
+ */
+void logFlush(void)
+{
+    if (drainMutex)
+        xSemaphoreTake(drainMutex, portMAX_DELAY);
+
+    drainRecords();
+    Serial.flush();
+
+    if (drainMutex)
+        xSemaphoreGive(drainMutex);
+}
+
+/**
+ * @brief Task printing the buffered records.
+ *
+ * @param pvParameters A pointer to task parameters (not used in this function).
+ */
+void loggerTask(void *pvParameters)
+{
+    for (;;)
+    {
+        xSemaphoreTake(drainMutex, portMAX_DELAY);
+        drainRecords();
+        xSemaphoreGive(drainMutex);
+
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+/**
+ * @brief Initializes the logger task, records written before are printed too.
+ *
+ * @note This function should be called once after the Serial has been started.
+ */
+void loggerInit(void)
+{
+    drainMutex = xSemaphoreCreateMutex();
+
+    if (pdPASS != xTaskCreatePinnedToCore(loggerTask,
+                                          "loggerTask",
+                                          LOGGER_TASK_STACK_SIZE,
+                                          NULL,
+                                          LOGGER_TASK_PRIORITY,
+                                          NULL,
+                                          LOGGER_TASK_CORE))
+    {
+        Serial.println("Failed to create loggerTask");
+    }
+}
+
+/**
+ * @brief Returns the number of records dropped because the buffer was full.
+ */
+uint32_t logDroppedCount(void)
+{
+    return records.overrunCount();
+}
@@ -0,0 +1,118 @@
+/**
+ * @file logger.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+#include <type_traits>
+
+/*
+ * Deferred logging.
+ *
+ * LOG_ERROR() ... LOG_DEBUG() store only the format string and the raw argument values into a lock-free
+ * ring buffer, the formatting and the serial output happen later in a low priority task. A full buffer
+ * drops records instead of blocking, so the macros are safe in callbacks and ISRs.
+ *
+ * Deferred arguments are limited to integers, enums and pointers. Strings passed to %s must stay valid
+ * until the record is printed (literals, static buffers), dynamic text goes through LOG_FORMATTED().
+ * Levels above LOG_LEVEL are compiled out together with their arguments.
+ */
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Maximum number of the deferred arguments and of the characters of a formatted record
+#define LOG_MAX_ARGS  12
+#define LOG_TEXT_SIZE 64
+
+// Number of records buffered until the drain task prints them
+#define LOG_BUFFER_SIZE 32
+
+void logWrite(uint8_t level, const char *format, const uintptr_t *args, uint8_t count);
+void logFormatted(uint8_t level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+void logFlush(void);
+void loggerInit(void);
+uint32_t logDroppedCount(void);
+
+// Never called, lets the compiler check the arguments against the format string
+static inline void logFormatCheck(const char *format, ...) __attribute__((format(printf, 1, 2)));
+static inline void logFormatCheck(const char *format, ...) {}
+
+template <typename T>
+inline uintptr_t logArg(T value)
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+                  "Only integers, enums and pointers can be logged deferred, use LOG_FORMATTED()");
+    static_assert(sizeof(T) <= sizeof(uintptr_t), "Values wider than a pointer can't be logged deferred, use LOG_FORMATTED()");
+
+    return (uintptr_t)value;
+}
+
+template <typename... Args>
+inline void logDeferred(uint8_t level, const char *format, Args... args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+
+    const uintptr_t values[] = {logArg(args)..., 0};
+    logWrite(level, format, values, sizeof...(Args));
+}
+
+#define LOG_DEFERRED(level, ...)             \
+    do                                       \
+    {                                        \
+        if (0)                               \
+            logFormatCheck(__VA_ARGS__);     \
+        logDeferred(level, __VA_ARGS__);     \
+    } while (0)
+
+#define LOG_DISABLED(...) \
+    do                    \
+    {                     \
+    } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_DEFERRED(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISABLED()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_DEFERRED(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISABLED()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_DEFERRED(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISABLED()
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_DEFERRED(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISABLED()
+#endif
+
+// Formats the text immediately (not in ISRs), for arguments that don't outlive the call
+#define LOG_FORMATTED(level, ...)                  \
+    do                                             \
+    {                                              \
+        if ((level) <= LOG_LEVEL)                  \
+            logFormatted((level), __VA_ARGS__);    \
+    } while (0)
+
+#endif // LOGGER_H
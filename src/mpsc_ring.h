@@ -0,0 +1,115 @@
+/**
+ * @file mpsc_ring.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * @brief Lock-free ring buffer for any number of producers and exactly one consumer.
+ *
+ * Every slot carries a sequence number telling whether it is free, being written or ready to be read, so
+ * producers only compete for the write position with a compare-and-swap and never block. Producers may
+ * live in tasks on both cores and in an ISR. When the buffer is full, new items are dropped and counted
+ * as overruns.
+ *
+ * @tparam T Type of the stored items (copied by value).
+ * @tparam Size Capacity of the buffer, must be a power of two.
+ */
+template <typename T, size_t Size>
+class MpscRing
+{
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "MpscRing size must be a power of two");
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence; // Position the slot is free for (writing) or position + 1 (ready)
+        T item;
+    };
+
+    Slot slots[Size];
+    std::atomic<uint32_t> head{0};     // Next position to write, shared by the producers
+    uint32_t tail = 0;                 // Next position to read, owned by the consumer
+    std::atomic<uint32_t> overruns{0}; // Number of items dropped because the buffer was full
+
+public:
+    MpscRing()
+    {
+        for (uint32_t i = 0; i < Size; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds an item to the buffer (any producer).
+     * @return True if the item was stored, false if the buffer was full.
+     */
+    bool push(const T &item)
+    {
+        uint32_t position = head.load(std::memory_order_relaxed);
+        Slot *slot;
+
+        for (;;)
+        {
+            slot = &slots[position & (Size - 1)];
+            int32_t diff = (int32_t)(slot->sequence.load(std::memory_order_acquire) - position);
+
+            if (diff == 0)
+            {
+                // The slot is free, try to claim the position
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // The slot still holds an unread item from the previous round
+                overruns.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                // Another producer claimed the position meanwhile
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->item = item;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest item from the buffer (consumer side).
+     * @return True if an item was read, false if the buffer was empty or the oldest item is still being written.
+     */
+    bool pop(T &item)
+    {
+        Slot &slot = slots[tail & (Size - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+            return false;
+
+        item = slot.item;
+        slot.sequence.store(tail + Size, std::memory_order_release);
+        tail++;
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of items dropped because the buffer was full.
+     */
+    uint32_t overrunCount() const
+    {
+        return overruns.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // MPSC_RING_H
@@ -11,20 +11,81 @@
 #include "display.h"
 #include "power_manager.h"
 
+#include <esp_idf_version.h>
+#include <esp_timer.h>
+
+#include "battery_curves.h"
 #include "constants.h"
+#include "esp_now_interface.h"
+#include "fast_boot.h"
+#include "logger.h"
+#include "seqlock.h"
 #include "wifi_ota_manager.h"
 
-// Formula to calculate the battery voltage (with a shorted diode)
-#define CALCULATE_BATT_MV(mv) ((mv) * 6.92 + 337)
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+#include <driver/adc.h>
+// The legacy driver reports when the WiFi holds the ADC2, the newer one is used by analogRead()
+#define BATTERY_USE_ADC2_LOCK 1
+#define BATTERY_ADC2_CHANNEL  ADC2_CHANNEL_0 // BATTERY_VOLTAGE_PIN
+#define BATTERY_ADC2_WIDTH    ADC_WIDTH_BIT_10 // BATTERY_ADC_BITS
+#else
+#define BATTERY_USE_ADC2_LOCK 0
+#endif
+
+// Formula to calculate the battery voltage (with a shorted diode) from a BATTERY_ADC_BITS reading
+#define CALCULATE_BATT_MV(mv) ((mv) * 692 / 100 + 337)
+#define BATTERY_ADC_BITS      10
+
+// Known point of the divider: a full cell of 4.2 V reads 558 in 10 bits
+static_assert(BATTERY_ADC_BITS == 10 && CALCULATE_BATT_MV(558) >= 4190 && CALCULATE_BATT_MV(558) <= 4210,
+              "CALCULATE_BATT_MV doesn't match the divider");
+
+// Highest voltage of the single cell battery, a reading above it has the wrong width (e.g. 12 bits)
+#define BATTERY_PLAUSIBLE_MAX_MV 5000
+
+// analogRead() returns 12-bit values, shifted to BATTERY_ADC_BITS for the formula above
+// (analogReadResolution() isn't used, it would also change the ADC1 width of the lever sampling)
+#define BATTERY_ANALOG_READ_SHIFT (12 - BATTERY_ADC_BITS)
+
+// Weight of a new measurement in the smoothed state of charge (1/N)
+#define BATTERY_SOC_SMOOTHING 4
+// Weight of a new measurement in the discharge rate (1/N)
+#define BATTERY_RATE_SMOOTHING 4
+
+// Number of readings averaged per measurement
+#define BATTERY_READINGS_COUNT 5
 
-// LiPo battery voltage limits for this setup
-#define MIN_BATT_MV 3200
-#define MAX_BATT_MV 4200
+// Delay before retrying a failed measurement in milliseconds
+#define BATTERY_RETRY_INTERVAL 1000
+// Measurements tried at the cold boot before the low battery check is left to readBatteryVoltage()
+#define BATTERY_BOOT_ATTEMPTS 3
+#define BATTERY_BOOT_RETRY_MS 50
+
+// Maximum time to wait for the frame in flight before pausing the radio in milliseconds
+#define BATTERY_RADIO_HOLD_TIMEOUT_MS 60
+
+// Stopping the radio disconnects the station, so while it is connected the measurement waits until
+// the levers are at rest for BATTERY_DEFER_IDLE_MS, but no longer than BATTERY_DEFER_MAX_MS
+#define BATTERY_DEFER_IDLE_MS 10000
+#define BATTERY_DEFER_MAX_MS  (15 * 60 * 1000)
 
 // Global variables
 extern controller_data_struct dataToSend;
+extern volatile uint32_t lastUserActivityTime;
 
 uint32_t lastBatteryReadTime = 0;
+static uint32_t lastMeasurementTime = 0; // Time of the last successful measurement
+static bool measurementDeferred = false;
+uint16_t battMv = 0; // Last measured battery voltage
+
+// The fast boot starts with the reading stored before the deep sleep and a cold boot may fail to measure,
+// the first successful measurement is checked instead
+bool lowThresholdPending = false;
+volatile bool batteryLow = false;
+
+BatteryStats batteryStats;
+SeqLock<BatteryStats> publishedBatteryStats;
+SeqLock<BatteryEstimate> publishedBatteryEstimate;
 
 /**
  * Function to put the system into deep sleep mode.
@@ -33,10 +94,11 @@ uint32_t lastBatteryReadTime = 0;
 void go_to_deep_sleep()
 {
     // Configure the board to wake up when the power button is pressed
-    Serial.println("Going to deep sleep mode...");
+    LOG_INFO("Going to deep sleep mode...");
     esp_sleep_enable_ext0_wakeup(POWER_BUTTON, 0);
 
-    // Enter deep sleep mode
+    // Print the buffered log records and enter deep sleep mode
+    logFlush();
     esp_deep_sleep_start();
 }
 
@@ -47,82 +109,252 @@ void setupPowerManager(Button &powerBtn)
 }
 
 /**
- * Calculates the battery percentage using a sigmoidal function.
+ * Calculates the battery percentage from the discharge curve selected by BATTERY_CURVE.
  *
  * @param voltage The input voltage value.
- * @return The sigmoidal value calculated based on the input voltage.
- *
- * @note Inspired by this repository: https://github.com/rlogiacco/BatterySense
+ * @return The state of charge in percent, looked up in the table generated at compile time.
  */
 uint8_t calculateBatteryLevel(uint16_t voltage)
 {
-    if (voltage <= MIN_BATT_MV)
-        return 0;
-    if (voltage >= MAX_BATT_MV)
-        return 100;
-
-    uint8_t result = 105 - (105 / (1 + pow(1.724 * (voltage - MIN_BATT_MV) / (MAX_BATT_MV - MIN_BATT_MV), 5.5)));
-    return result >= 100 ? 100 : result;
+    return batteryCurveLevel(voltage);
 }
 
-uint16_t getAveragedBattVoltage()
+/**
+ * @brief Updates the smoothed state of charge and the remaining time with a new measurement.
+ *
+ * @param voltage The measured battery voltage in millivolts.
+ */
+static void updateBatteryEstimate(uint16_t voltage)
 {
-// Define the number of readings
-#define NUM_READINGS 5
+    // State of charge and the discharge rate in 1/256 percent
+    static int32_t socX256 = -1;
+    static int32_t ratePerHourX256 = 0;
+    static uint32_t lastUpdateTime = 0;
+
+    int32_t sampleX256 = calculateBatteryLevel(voltage) << 8;
+    uint32_t now = millis();
+
+    if (socX256 < 0)
+    {
+        socX256 = sampleX256;
+    }
+    else
+    {
+        int32_t previousX256 = socX256;
+        socX256 += (sampleX256 - socX256) / BATTERY_SOC_SMOOTHING;
+
+        // Discharge rate since the previous measurement
+        uint32_t elapsed = now - lastUpdateTime;
+        if (elapsed)
+        {
+            int32_t sampleRate = (int64_t)(previousX256 - socX256) * 3600000 / elapsed;
+            ratePerHourX256 += (sampleRate - ratePerHourX256) / BATTERY_RATE_SMOOTHING;
+        }
+    }
+    lastUpdateTime = now;
+
+    BatteryEstimate estimate;
+    estimate.socPercent = (socX256 + 128) >> 8;
+    estimate.minutesRemaining = BATTERY_MINUTES_UNKNOWN;
+    if (ratePerHourX256 > 0)
+        estimate.minutesRemaining = min<int64_t>((int64_t)socX256 * 60 / ratePerHourX256, BATTERY_MINUTES_UNKNOWN - 1);
+    publishedBatteryEstimate.write(estimate);
+}
 
+/**
+ * @brief Takes BATTERY_READINGS_COUNT back to back readings of the battery voltage.
+ *
+ * @param battMv The averaged battery voltage in millivolts.
+ * @return False if the ADC2 is held by the WiFi or the reading is implausible.
+ */
+static bool sampleBatteryVoltage(uint16_t &battMv)
+{
     uint32_t total = 0;
 
-    // Take multiple readings
-    for (int i = 0; i < NUM_READINGS; ++i)
+    for (uint8_t i = 0; i < BATTERY_READINGS_COUNT; ++i)
     {
-        total += analogRead(BATTERY_VOLTAGE_PIN);
-        delay(10); // Short delay between readings
+#if BATTERY_USE_ADC2_LOCK
+        int raw;
+        if (adc2_get_raw(BATTERY_ADC2_CHANNEL, BATTERY_ADC2_WIDTH, &raw) != ESP_OK)
+            return false;
+        total += raw;
+#else
+        total += analogRead(BATTERY_VOLTAGE_PIN) >> BATTERY_ANALOG_READ_SHIFT;
+#endif
     }
 
-    // Calculate the average reading
-    uint16_t avgReadMv = total / NUM_READINGS;
+    // Calculate the battery voltage from the average reading using formula
+    battMv = CALCULATE_BATT_MV(total / BATTERY_READINGS_COUNT);
+    if (battMv > BATTERY_PLAUSIBLE_MAX_MV)
+    {
+        LOG_ERROR("Implausible battery voltage %u mV, check the ADC width", battMv);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Measures the battery voltage with the radio stopped.
+ *
+ * The WiFi driver holds the ADC2 as long as it is started (the PHY never powers down in the AP+STA
+ * mode), so the radio is stopped for the readings right after the frame in flight is completed.
+ * Neither the WiFi mode nor ESP-NOW are reinitialized, but a connected station has to join its
+ * access point again, that time is reported separately by updateRejoinStats().
+ *
+ * @param battMv The measured battery voltage in millivolts.
+ * @return False if the radio couldn't be held.
+ */
+static bool measureWithRadioPaused(uint16_t &battMv)
+{
+    if (!holdRadio(BATTERY_RADIO_HOLD_TIMEOUT_MS))
+        return false;
+
+    uint32_t startUs = esp_timer_get_time();
 
-    // Calculate the battery voltage using formula
-    uint16_t battMv = CALCULATE_BATT_MV(avgReadMv);
+    bool reconnect = pauseWiFiRadio();
+    bool measured = sampleBatteryVoltage(battMv);
+    resumeWiFiRadio(reconnect);
+    batteryStats.radioStops++;
 
-    return battMv;
+    releaseRadio();
+
+    // Time the control link was blind
+    batteryStats.lastBlindUs = (uint32_t)esp_timer_get_time() - startUs;
+    batteryStats.maxBlindUs = max(batteryStats.maxBlindUs, batteryStats.lastBlindUs);
+
+    return measured;
 }
 
-uint16_t readBatteryVoltage(bool reEnableWiFi)
+/**
+ * @brief Records the time the station needed to join the access point again after a radio stop.
+ */
+static void updateRejoinStats(void)
+{
+    uint32_t rejoinUs = takeWiFiReconnectUs();
+    if (!rejoinUs)
+        return;
+
+    batteryStats.lastRejoinUs = rejoinUs;
+    batteryStats.maxRejoinUs = max(batteryStats.maxRejoinUs, rejoinUs);
+    publishedBatteryStats.write(batteryStats);
+    LOG_INFO("WiFi station connected again %u us after the battery measurement", rejoinUs);
+}
+
+/**
+ * @brief Returns true if the measurement should wait, stopping the radio would disconnect the
+ *        station while the user is controlling the Excavator.
+ */
+static bool deferMeasurement(void)
 {
-    static uint16_t battMv = 0;
+    uint32_t now = millis();
+
+    if (!isWiFiConnected() || lastMeasurementTime == 0)
+        return false;
+    if (now - lastUserActivityTime >= BATTERY_DEFER_IDLE_MS)
+        return false;
+    return now - lastMeasurementTime < BATTERY_READ_INTERVAL + BATTERY_DEFER_MAX_MS;
+}
+
+/**
+ * @brief Reads the battery voltage every BATTERY_READ_INTERVAL milliseconds.
+ *
+ * Safe to call at any time, also while the user is controlling the Excavator. A measurement that
+ * would disconnect the WiFi station is postponed until the levers are at rest, a failed measurement
+ * is retried on the next call.
+ *
+ * @return The last measured battery voltage in millivolts, 0 if not measured yet.
+ */
+uint16_t readBatteryVoltage()
+{
+    updateRejoinStats();
 
     // Read the battery voltage every BATTERY_READ_INTERVAL milliseconds or if it's the first run
-    if (millis() - lastBatteryReadTime >= BATTERY_READ_INTERVAL || lastBatteryReadTime == 0)
+    if (millis() - lastBatteryReadTime < BATTERY_READ_INTERVAL && lastBatteryReadTime != 0)
+        return battMv;
+
+    uint16_t measuredMv = 0;
+    bool measured;
+
+    // The ADC2 is free while the WiFi is disabled (e.g. during the startup)
+    if (!isWiFiEnabled())
+    {
+        measured = sampleBatteryVoltage(measuredMv);
+        batteryStats.lastBlindUs = 0;
+    }
+    else if (deferMeasurement())
+    {
+        // Checked again after BATTERY_RETRY_INTERVAL milliseconds
+        lastBatteryReadTime = millis() - BATTERY_READ_INTERVAL + BATTERY_RETRY_INTERVAL;
+        measurementDeferred = true;
+        return battMv;
+    }
+    else
+    {
+        measured = measureWithRadioPaused(measuredMv);
+    }
+
+    if (measurementDeferred)
+    {
+        measurementDeferred = false;
+        batteryStats.deferrals++;
+    }
+
+    if (measured)
     {
         lastBatteryReadTime = millis();
-        Serial.println("Reading battery voltage...");
+        lastMeasurementTime = lastBatteryReadTime;
+        battMv = measuredMv;
+        fastBootSaveBattery(battMv);
+        batteryStats.measurements++;
+        updateBatteryEstimate(battMv);
+        LOG_INFO("Battery Voltage: %u mV | Link paused for %u us", battMv, batteryStats.lastBlindUs);
 
-        // If reenableWiFi is true, disable the WiFi before reading the battery voltage
-        if (reEnableWiFi)
+        if (lowThresholdPending)
         {
-            disableWiFi();
-        }
-        // If the WiFi is enabled and reenableWiFi is false, print an error message and return
-        else if (isWiFiEnabled())
-        {
-            Serial.println("WiFi must be disabled to read the battery voltage!");
-            return 0;
+            lowThresholdPending = false;
+            batteryLow = battMv < BATTERY_LOW_THRESHOLD;
+            if (batteryLow)
+                LOG_WARN("Battery voltage is too low");
         }
+    }
+    else
+    {
+        // Retry after BATTERY_RETRY_INTERVAL milliseconds
+        lastBatteryReadTime = millis() - BATTERY_READ_INTERVAL + BATTERY_RETRY_INTERVAL;
+        batteryStats.failures++;
+        LOG_WARN("Battery voltage measurement failed");
+    }
 
-        // Reset the value so we can detect if there was an error reading the battery voltage
-        battMv = 0;
+    publishedBatteryStats.write(batteryStats);
 
-        // Read the battery voltage
-        battMv = getAveragedBattVoltage();
-        Serial.printf("Battery Voltage: %u mV\n", battMv);
+    return battMv;
+}
 
-        // Re-enable the WiFi if needed
-        if (reEnableWiFi)
-            enableWiFi();
-    }
+/**
+ * @brief Returns a consistent copy of the battery measurement statistics.
+ */
+BatteryStats getBatteryStats(void)
+{
+    return publishedBatteryStats.read();
+}
 
-    return battMv;
+/**
+ * @brief Returns the smoothed state of charge and the estimated remaining time.
+ */
+BatteryEstimate getBatteryEstimate(void)
+{
+    return publishedBatteryEstimate.read();
+}
+
+/**
+ * @brief Returns true if the first measurement after the fast boot (or after a failed measurement at the
+ *        cold boot) found the battery voltage too low.
+ *
+ * The housekeeping task powers off the board then, the link is already running at that time.
+ */
+bool isBatteryLow(void)
+{
+    return batteryLow;
 }
 
 /**
@@ -130,18 +362,44 @@ uint16_t readBatteryVoltage(bool reEnableWiFi)
  *
  * This function reads the battery voltage and checks if it is too low. If the battery voltage is below a certain threshold,
  * it displays a low power message on the displays, goes into deep sleep mode, and disables the display and status LED.
+ * The fast boot doesn't wait for a measurement, the threshold is applied to the first one by readBatteryVoltage().
+ * The same happens if the cold boot gets no valid measurement, a missing reading doesn't mean a flat battery.
  */
 void verifyBatteryLevel()
 {
-    // Read the battery voltage before going to sleep
-    dataToSend.battery = readBatteryVoltage(false);
+    // The fast boot starts with the last reading, the first measurement follows shortly with the radio paused
+    if (isFastBoot())
+    {
+        battMv = getFastBootBatteryMv();
+        dataToSend.battery = battMv;
+        lowThresholdPending = true;
+        return;
+    }
+
+    // A rejected reading leaves battMv at 0, try again before giving up
+    for (uint8_t attempt = 0; attempt < BATTERY_BOOT_ATTEMPTS && battMv == 0; attempt++)
+    {
+        if (attempt)
+            delay(BATTERY_BOOT_RETRY_MS);
+        lastBatteryReadTime = 0;
+        readBatteryVoltage();
+    }
+
+    dataToSend.battery = battMv;
+    if (battMv == 0)
+    {
+        LOG_ERROR("Battery voltage not measured, the low battery check is postponed");
+        lowThresholdPending = true;
+        return;
+    }
+
     if (dataToSend.battery < BATTERY_LOW_THRESHOLD)
     {
-        Serial.println("Battery voltage is too low");
+        LOG_WARN("Battery voltage is too low");
         // Show low power message on the displays
         setDisplayState(DISPLAY_LOW_POWER);
         // Go to deep sleep mode after delay
-        delay(5000);
+        delay(BATTERY_LOW_MESSAGE_MS);
         disableDisplay();
         digitalWrite(STATUS_LED, LOW);
         go_to_deep_sleep();
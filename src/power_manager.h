@@ -12,10 +12,39 @@
 
 #include <EncButton.h>
 
+// Statistics of the battery measurements
+struct BatteryStats
+{
+    uint32_t measurements; // Completed measurements
+    uint32_t radioStops;   // Measurements that stopped the radio to get the ADC2
+    uint32_t deferrals;    // Measurements postponed until the levers were at rest
+    uint32_t failures;     // Measurements retried because the radio or the ADC2 wasn't available
+    uint32_t lastBlindUs;  // Time the control link was paused by the last measurement in microseconds
+    uint32_t maxBlindUs;   // Longest pause of the control link in microseconds
+    uint32_t lastRejoinUs; // Time from the last radio stop until the station was connected again in microseconds
+    uint32_t maxRejoinUs;  // Longest time until the station was connected again in microseconds
+};
+
+// Smoothed state of charge of the controller battery
+struct BatteryEstimate
+{
+    uint8_t socPercent;        // State of charge in percent
+    uint16_t minutesRemaining; // Estimated time to the empty battery, BATTERY_MINUTES_UNKNOWN if not discharging
+};
+
+// Remaining time is unknown until the battery was measured twice with a falling state of charge
+#define BATTERY_MINUTES_UNKNOWN 0xFFFF
+
+// Time the low power message is shown before the board goes to deep sleep in milliseconds
+#define BATTERY_LOW_MESSAGE_MS 5000
+
 void setupPowerManager(Button &powerBtn);
 void go_to_deep_sleep(void);
-uint16_t readBatteryVoltage(bool reEnableWiFi = true);
+uint16_t readBatteryVoltage(void);
+BatteryStats getBatteryStats(void);
+BatteryEstimate getBatteryEstimate(void);
 void verifyBatteryLevel(void);
+bool isBatteryLow(void);
 uint8_t calculateBatteryLevel(uint16_t voltage);
 
 #endif // POWER_MANAGER_H
\ No newline at end of file
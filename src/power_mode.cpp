@@ -0,0 +1,222 @@
+/**
+ * @file power_mode.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "power_mode.h"
+
+#include <Arduino.h>
+#include <atomic>
+#include <driver/gpio.h>
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <freertos/semphr.h>
+
+#include "logger.h"
+#include "seqlock.h"
+
+// The framework has to be built with the power management to scale the frequency automatically,
+// otherwise the frequency is switched with setCpuFrequencyMhz() on the mode changes
+#ifdef CONFIG_PM_ENABLE
+#define POWER_USE_PM 1
+#else
+#define POWER_USE_PM 0
+#endif
+
+// The automatic light sleep needs the tickless idle of the FreeRTOS in addition
+#if POWER_USE_PM && defined(CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+#define POWER_USE_LIGHT_SLEEP 1
+#else
+#define POWER_USE_LIGHT_SLEEP 0
+#endif
+
+// Global variables
+extern volatile uint32_t lastUserActivityTime;
+
+static std::atomic<PowerMode> mode{POWER_MODE_ACTIVE};
+static SemaphoreHandle_t modeMutex = NULL;
+static uint32_t activeCpuFreqMhz = 0;
+static uint32_t modeSinceMs = 0;
+static int64_t wakeUs = 0; // Time of the last wake-up not yet followed by a frame, 0 if none
+
+#if POWER_USE_PM
+static esp_pm_lock_handle_t activeLock = NULL; // Held in the active mode, keeps the maximum CPU frequency
+#endif
+
+static PowerModeStats stats;
+static SeqLock<PowerModeStats> publishedStats;
+
+/**
+ * @brief Adds the time spent in the current mode to the statistics.
+ *
+ * @note Must be called with the mode mutex taken.
+ */
+static void accountModeTime()
+{
+    uint32_t now = millis();
+    if (mode == POWER_MODE_IDLE)
+        stats.idleMs += now - modeSinceMs;
+    else
+        stats.activeMs += now - modeSinceMs;
+    modeSinceMs = now;
+}
+
+/**
+ * @brief Switches between the power modes.
+ *
+ * @note Must be called with the mode mutex taken.
+ */
+static void setPowerMode(PowerMode newMode)
+{
+    if (mode == newMode)
+        return;
+
+    accountModeTime();
+
+#if POWER_USE_PM
+    if (newMode == POWER_MODE_ACTIVE)
+        esp_pm_lock_acquire(activeLock);
+    else
+        esp_pm_lock_release(activeLock);
+#else
+    setCpuFrequencyMhz(newMode == POWER_MODE_ACTIVE ? activeCpuFreqMhz : POWER_IDLE_CPU_FREQ_MHZ);
+#endif
+
+    mode = newMode;
+    publishedStats.write(stats);
+}
+
+/**
+ * @brief Configures the power management and starts in the active mode.
+ *
+ * @note This function should be called once during the setup phase of the program.
+ */
+void powerModeInit(void)
+{
+    modeMutex = xSemaphoreCreateMutex();
+    activeCpuFreqMhz = getCpuFrequencyMhz();
+    modeSinceMs = millis();
+
+#if POWER_USE_PM
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    esp_pm_config_t config = {};
+#else
+    esp_pm_config_esp32_t config = {};
+#endif
+    config.max_freq_mhz = activeCpuFreqMhz;
+    config.min_freq_mhz = POWER_IDLE_CPU_FREQ_MHZ;
+    config.light_sleep_enable = POWER_USE_LIGHT_SLEEP;
+
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "active", &activeLock) != ESP_OK ||
+        esp_pm_configure(&config) != ESP_OK)
+    {
+        LOG_ERROR("Failed to configure the power management");
+    }
+    esp_pm_lock_acquire(activeLock);
+#endif
+
+#if POWER_USE_LIGHT_SLEEP
+    // Any pressed button ends the light sleep immediately
+    const gpio_num_t wakeupButtons[] = {POWER_BUTTON, MAIN_LIGHTS_BUTTON, CENTER_SWING_BUTTON, BEACON_LIGHT_MODE_BUTTON};
+    for (gpio_num_t pin : wakeupButtons)
+        gpio_wakeup_enable(pin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+#endif
+
+    LOG_INFO("Power modes: active %u MHz, idle %u MHz, light sleep %s", activeCpuFreqMhz, POWER_IDLE_CPU_FREQ_MHZ,
+             POWER_USE_LIGHT_SLEEP ? "enabled" : "not available");
+}
+
+/**
+ * @brief Switches to the active mode on any user activity.
+ *
+ * Cheap in the active mode, may be called with every lever movement or button click.
+ */
+void powerModeWake(void)
+{
+    if (mode == POWER_MODE_ACTIVE || !modeMutex)
+        return;
+
+    xSemaphoreTake(modeMutex, portMAX_DELAY);
+    if (mode == POWER_MODE_IDLE)
+    {
+        wakeUs = esp_timer_get_time();
+        setPowerMode(POWER_MODE_ACTIVE);
+    }
+    xSemaphoreGive(modeMutex);
+}
+
+/**
+ * @brief Enters the idle mode after POWER_IDLE_DELAY_MS of inactivity.
+ *
+ * @note This function should be called periodically.
+ */
+void powerModeUpdate(void)
+{
+    if (!modeMutex)
+        return;
+
+    xSemaphoreTake(modeMutex, portMAX_DELAY);
+    if (mode == POWER_MODE_ACTIVE && millis() - lastUserActivityTime > POWER_IDLE_DELAY_MS)
+    {
+        stats.idleEntries++;
+        setPowerMode(POWER_MODE_IDLE);
+    }
+
+    accountModeTime();
+    publishedStats.write(stats);
+    xSemaphoreGive(modeMutex);
+}
+
+/**
+ * @brief Measures the wake-to-send latency, called after a frame was posted to the radio task.
+ */
+void powerModeFrameSent(void)
+{
+    if (!wakeUs)
+        return;
+
+    xSemaphoreTake(modeMutex, portMAX_DELAY);
+    if (wakeUs)
+    {
+        stats.lastWakeToSendUs = esp_timer_get_time() - wakeUs;
+        stats.maxWakeToSendUs = max(stats.maxWakeToSendUs, stats.lastWakeToSendUs);
+        if (stats.lastWakeToSendUs > POWER_WAKE_TO_SEND_MAX_MS * 1000UL)
+            stats.lateWakeups++;
+        wakeUs = 0;
+        publishedStats.write(stats);
+    }
+    xSemaphoreGive(modeMutex);
+}
+
+/**
+ * @brief Returns the current power mode.
+ */
+PowerMode getPowerMode(void)
+{
+    return mode;
+}
+
+/**
+ * @brief Returns the period of the periodic tasks in the current power mode.
+ *
+ * @param activePeriod The period in the active mode in ticks.
+ */
+TickType_t powerModePeriod(TickType_t activePeriod)
+{
+    return mode == POWER_MODE_IDLE ? pdMS_TO_TICKS(POWER_IDLE_PERIOD_MS) : activePeriod;
+}
+
+/**
+ * @brief Returns a consistent copy of the power mode statistics.
+ */
+PowerModeStats getPowerModeStats(void)
+{
+    return publishedStats.read();
+}
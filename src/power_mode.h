@@ -0,0 +1,61 @@
+/**
+ * @file power_mode.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef POWER_MODE_H
+#define POWER_MODE_H
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+
+#include "constants.h"
+
+/*
+ * Idle power mode.
+ *
+ * After POWER_IDLE_DELAY_MS without any lever movement or button click the CPU frequency is lowered
+ * and the periodic tasks (ADC, sampling, control) run every POWER_IDLE_PERIOD_MS instead of every
+ * sampling interval. With the power management and the tickless idle enabled in the framework the CPU
+ * also enters the automatic light sleep between these cycles, woken by the task timers or a button.
+ *
+ * The first lever movement is seen in the next idle ADC frame and sent in the next control cycle,
+ * so the wake-to-send latency stays below POWER_WAKE_TO_SEND_MAX_MS.
+ */
+#define POWER_IDLE_DELAY_MS     3000 // Inactivity before entering the idle mode
+#define POWER_IDLE_PERIOD_MS    20   // Period of the ADC, sampling and control tasks in the idle mode
+#define POWER_IDLE_CPU_FREQ_MHZ 80   // Lowest CPU frequency supported with the WiFi running
+
+// Guaranteed maximum time from the first lever movement in the idle mode to posting the frame
+#define POWER_WAKE_TO_SEND_MAX_MS (2 * POWER_IDLE_PERIOD_MS + ADC_FRAME_INTERVAL_MS)
+
+enum PowerMode : uint8_t
+{
+    POWER_MODE_ACTIVE, // Full CPU frequency, tasks run at the sampling rate
+    POWER_MODE_IDLE,   // Lowest CPU frequency (and light sleep), tasks run every POWER_IDLE_PERIOD_MS
+};
+
+// Statistics of the power modes
+struct PowerModeStats
+{
+    uint32_t idleEntries;      // Number of switches to the idle mode
+    uint32_t idleMs;           // Total time spent in the idle mode in milliseconds
+    uint32_t activeMs;         // Total time spent in the active mode in milliseconds
+    uint32_t lastWakeToSendUs; // Time from the last wake-up to posting the frame in microseconds
+    uint32_t maxWakeToSendUs;  // Longest time from a wake-up to posting the frame in microseconds
+    uint32_t lateWakeups;      // Wake-ups exceeding POWER_WAKE_TO_SEND_MAX_MS
+};
+
+void powerModeInit(void);
+void powerModeWake(void);
+void powerModeUpdate(void);
+void powerModeFrameSent(void);
+PowerMode getPowerMode(void);
+TickType_t powerModePeriod(TickType_t activePeriod);
+PowerModeStats getPowerModeStats(void);
+
+#endif // POWER_MODE_H
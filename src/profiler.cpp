@@ -0,0 +1,115 @@
+/**
+ * @file profiler.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "profiler.h"
+
+#include <Arduino.h>
+
+#include "constants.h"
+
+// Time budget of the periodic stages
+#define SAMPLING_BUDGET_US (1000000UL / LEVER_SAMPLING_RATE_HZ)
+#define OTA_BUDGET_US      20000UL
+
+struct StageInfo
+{
+    const char *name;
+    uint32_t budgetUs; // Measurements longer than this are counted as overruns
+};
+
+static const StageInfo stageInfos[PROFILE_STAGES_COUNT] = {
+    {"sampling cycle", SAMPLING_BUDGET_US},
+    {"processLevers", SAMPLING_BUDGET_US},
+    {"control cycle", SAMPLING_BUDGET_US},
+    {"tickButtons", SAMPLING_BUDGET_US},
+    {"checkAndSendData", SAMPLING_BUDGET_US},
+    {"handleOTA", OTA_BUDGET_US},
+};
+
+// Every stage is written by a single task only, readers may see a partially updated histogram
+static ProfileStats stageStats[PROFILE_STAGES_COUNT];
+
+/**
+ * @brief Records one measurement of the stage.
+ *
+ * @param stage The measured stage.
+ * @param cycles Duration of the measurement in CPU cycles.
+ */
+void profilerRecord(ProfileStage stage, uint32_t cycles)
+{
+    // The frequency changes with the power mode
+    uint32_t cyclesPerUs = ESP.getCpuFreqMHz();
+    uint32_t durationUs = cycles / cyclesPerUs;
+
+    // Index of the power-of-two bucket is the number of significant bits
+    uint8_t bucket = durationUs ? 32 - __builtin_clz(durationUs) : 0;
+    if (bucket >= PROFILER_BUCKETS_COUNT)
+        bucket = PROFILER_BUCKETS_COUNT - 1;
+
+    ProfileStats &stats = stageStats[stage];
+    stats.buckets[bucket]++;
+    stats.count++;
+    if (durationUs > stats.maxUs)
+        stats.maxUs = durationUs;
+    if (durationUs > stageInfos[stage].budgetUs)
+        stats.overruns++;
+}
+
+/**
+ * @brief Returns a copy of the stage statistics with the 99th percentile calculated from the histogram.
+ */
+ProfileStats getProfileStats(ProfileStage stage)
+{
+    ProfileStats stats = stageStats[stage];
+    uint32_t threshold = stats.count - stats.count / 100;
+    uint32_t cumulative = 0;
+
+    stats.p99Us = stats.maxUs;
+    for (uint8_t i = 0; i < PROFILER_BUCKETS_COUNT - 1; i++)
+    {
+        cumulative += stats.buckets[i];
+        if (cumulative >= threshold)
+        {
+            stats.p99Us = min<uint32_t>(1UL << i, stats.maxUs);
+            break;
+        }
+    }
+
+    return stats;
+}
+
+/**
+ * @brief Clears the statistics of all stages.
+ */
+void profilerReset(void)
+{
+    memset(stageStats, 0, sizeof(stageStats));
+}
+
+/**
+ * @brief Prints the statistics and histograms of all stages to the serial port.
+ */
+void profilerDump(void)
+{
+#ifndef PROFILER_ENABLED
+    Serial.println("Profiler is disabled, build with -D PROFILER_ENABLED");
+#else
+    Serial.printf("%-18s %10s %8s %8s %9s  histogram [<1, <2, <4 ... >=16384 us]\n",
+                  "stage", "count", "p99 us", "max us", "overruns");
+    for (uint8_t stage = 0; stage < PROFILE_STAGES_COUNT; stage++)
+    {
+        ProfileStats stats = getProfileStats((ProfileStage)stage);
+        Serial.printf("%-18s %10u %8u %8u %9u ", stageInfos[stage].name, stats.count, stats.p99Us,
+                      stats.maxUs, stats.overruns);
+        for (uint8_t i = 0; i < PROFILER_BUCKETS_COUNT; i++)
+            Serial.printf(" %u", stats.buckets[i]);
+        Serial.println();
+    }
+#endif
+}
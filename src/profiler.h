@@ -0,0 +1,88 @@
+/**
+ * @file profiler.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+/*
+ * Hot path profiler based on the CPU cycle counter.
+ *
+ * Build with -D PROFILER_ENABLED to measure the stages, otherwise PROFILE_SCOPE() compiles to nothing.
+ * Every stage feeds a histogram of power-of-two microsecond buckets, dumped with the "prof" serial command.
+ */
+
+// Number of histogram buckets: bucket 0 collects durations below 1 us, bucket i durations of [2^(i-1), 2^i) us
+#define PROFILER_BUCKETS_COUNT 16
+
+// Profiled stages
+enum ProfileStage : uint8_t
+{
+    PROFILE_SAMPLING_CYCLE, // Whole cycle of the sampling task
+    PROFILE_PROCESS_LEVERS, // processLevers()
+    PROFILE_CONTROL_CYCLE,  // Whole cycle of the control task
+    PROFILE_TICK_BUTTONS,   // tickButtons()
+    PROFILE_CHECK_AND_SEND, // checkAndSendData()
+    PROFILE_HANDLE_OTA,     // handleOTA()
+    PROFILE_STAGES_COUNT
+};
+
+// Statistics of one stage
+struct ProfileStats
+{
+    uint32_t count;                           // Number of measurements
+    uint32_t maxUs;                           // Longest measured duration in microseconds
+    uint32_t p99Us;                           // 99th percentile (upper bound of the histogram bucket) in microseconds
+    uint32_t overruns;                        // Measurements longer than the budget of the stage
+    uint32_t buckets[PROFILER_BUCKETS_COUNT]; // Histogram of the durations
+};
+
+void profilerRecord(ProfileStage stage, uint32_t cycles);
+ProfileStats getProfileStats(ProfileStage stage);
+void profilerReset(void);
+void profilerDump(void);
+
+#ifdef PROFILER_ENABLED
+
+#include <Arduino.h>
+
+/**
+ * @brief Measures the lifetime of the object in CPU cycles and records it for the given stage.
+ *
+ * The cycle counter is per core, so the scope must not migrate between cores (all profiled tasks are pinned).
+ */
+class ProfileScope
+{
+private:
+    ProfileStage stage;
+    uint32_t startCycles;
+
+public:
+    explicit ProfileScope(ProfileStage _stage) : stage(_stage), startCycles(ESP.getCycleCount()) {}
+    ~ProfileScope() { profilerRecord(stage, ESP.getCycleCount() - startCycles); }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage)  ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(stage)
+
+#else
+
+#define PROFILE_SCOPE(stage) \
+    do                       \
+    {                        \
+    } while (0)
+
+#endif // PROFILER_ENABLED
+
+#endif // PROFILER_H
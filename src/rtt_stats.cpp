@@ -0,0 +1,97 @@
+/**
+ * @file rtt_stats.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "rtt_stats.h"
+
+#include <esp_timer.h>
+
+#include "seqlock.h"
+
+// Echoes of frames older than this are ignored (the 8-bit sequence number wraps around)
+#define RTT_MAX_AGE_US 2000000UL
+
+// Send time of every sequence number in microseconds, 0 - not sent or already echoed
+static volatile uint32_t sentTimesUs[256];
+
+// Histogram and totals, updated only from the receive callback
+static uint32_t buckets[RTT_BUCKETS_COUNT];
+static uint64_t totalUs = 0;
+static RttStats stats = {0, UINT32_MAX, 0, 0, 0};
+
+static SeqLock<RttStats> publishedStats;
+
+/**
+ * @brief Remembers the send time of the frame with the given sequence number.
+ */
+void rttFrameSent(uint8_t sequence)
+{
+    // Zero is reserved for "not sent"
+    uint32_t now = esp_timer_get_time();
+    sentTimesUs[sequence] = now ? now : 1;
+}
+
+/**
+ * @brief Calculates the 99th percentile from the histogram.
+ */
+static uint32_t histogramPercentile99()
+{
+    uint32_t threshold = stats.count - stats.count / 100;
+    uint32_t cumulative = 0;
+
+    for (uint8_t i = 0; i < RTT_BUCKETS_COUNT; i++)
+    {
+        cumulative += buckets[i];
+        if (cumulative >= threshold)
+            return i < RTT_BUCKETS_COUNT - 1 ? (i + 1) * RTT_BUCKET_WIDTH_US : stats.maxUs;
+    }
+
+    return stats.maxUs;
+}
+
+/**
+ * @brief Records the round trip of an echoed frame.
+ *
+ * @param sequence The sequence number echoed by the Excavator.
+ * @param holdUs Time the Excavator held the echo before sending it back in microseconds.
+ * @param receivedUs Time the echo was received by the radio in microseconds, so the delay of the
+ *                   telemetry task is not counted in the round trip.
+ */
+void rttEchoReceived(uint8_t sequence, uint32_t holdUs, uint32_t receivedUs)
+{
+    uint32_t sentUs = sentTimesUs[sequence];
+    if (!sentUs)
+        return; // Unknown or already measured frame
+
+    sentTimesUs[sequence] = 0;
+
+    uint32_t elapsedUs = receivedUs - sentUs;
+    if (elapsedUs > RTT_MAX_AGE_US || holdUs >= elapsedUs)
+        return; // Stale echo or inconsistent hold time
+
+    uint32_t rttUs = elapsedUs - holdUs;
+    uint32_t bucket = rttUs / RTT_BUCKET_WIDTH_US;
+    buckets[bucket < RTT_BUCKETS_COUNT ? bucket : RTT_BUCKETS_COUNT - 1]++;
+
+    stats.count++;
+    totalUs += rttUs;
+    stats.minUs = rttUs < stats.minUs ? rttUs : stats.minUs;
+    stats.maxUs = rttUs > stats.maxUs ? rttUs : stats.maxUs;
+    stats.avgUs = totalUs / stats.count;
+    stats.p99Us = histogramPercentile99();
+
+    publishedStats.write(stats);
+}
+
+/**
+ * @brief Returns a consistent copy of the round-trip time statistics.
+ */
+RttStats getRttStats(void)
+{
+    return publishedStats.read();
+}
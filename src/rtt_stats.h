@@ -0,0 +1,33 @@
+/**
+ * @file rtt_stats.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef RTT_STATS_H
+#define RTT_STATS_H
+
+#include <stdint.h>
+
+// Histogram of the round-trip times: RTT_BUCKETS_COUNT buckets of RTT_BUCKET_WIDTH_US, the last one collects the rest
+#define RTT_BUCKET_WIDTH_US 500
+#define RTT_BUCKETS_COUNT   41
+
+// Round-trip time statistics measured from the sequence numbers echoed by the Excavator
+struct RttStats
+{
+    uint32_t count; // Number of measured round trips
+    uint32_t minUs; // Minimum round-trip time in microseconds
+    uint32_t avgUs; // Average round-trip time in microseconds
+    uint32_t p99Us; // 99th percentile (upper bound of the histogram bucket) in microseconds
+    uint32_t maxUs; // Maximum round-trip time in microseconds
+};
+
+void rttFrameSent(uint8_t sequence);
+void rttEchoReceived(uint8_t sequence, uint32_t holdUs, uint32_t receivedUs);
+RttStats getRttStats(void);
+
+#endif // RTT_STATS_H
@@ -0,0 +1,307 @@
+/**
+ * @file sampling_task.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "sampling_task.h"
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#include "adc_sampler.h"
+#include "constants.h"
+#include "display.h"
+#include "lever_calibration.h"
+#include "lever_config.h"
+#include "lever_control.h"
+#include "logger.h"
+#include "power_mode.h"
+#include "profiler.h"
+#include "seqlock.h"
+
+// Task parameters
+#define SAMPLING_TASK_STACK_SIZE (4 * 1024U)
+#define SAMPLING_TASK_PRIORITY   (tskIDLE_PRIORITY + 4)
+#define SAMPLING_TASK_CORE       1 // Core 0 is used by the WiFi
+
+#define SAMPLING_INTERVAL_US (1000000UL / LEVER_SAMPLING_RATE_HZ)
+
+// Global variables
+extern controller_data_struct dataToSend;
+extern volatile uint32_t lastUserActivityTime;
+
+std::atomic<bool> anyLeverMoved{false};
+
+// Levers, configured in lever_config.h
+LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW> levers(leverConfigs);
+
+// Background sampler delivering ADC frames of all levers
+ContinuousAdcSource adcSource;
+
+bool leversCalibrated = false;
+
+// Ring of the latest lever samples, the newest one at head - 1
+struct LeverHistory
+{
+    LeverSample samples[LEVER_HISTORY_SIZE];
+    uint8_t head;
+    uint8_t count;
+};
+
+// Published data and statistics
+SeqLock<ControllerSnapshot> controllerSnapshot;
+SeqLock<LeverHistory> leverHistory;
+SeqLock<SamplingStats> samplingStats;
+
+/**
+ * @brief Updates the positions of all levers and handles user activity.
+ *
+ * This function consumes all ADC frames sampled since the last call and updates the positions of all levers.
+ * The first frames are used to calibrate the levers. If any lever position has changed, it updates the last
+ * user activity time.
+ *
+ * @param snapshot The snapshot to store the lever positions and the frame timestamp to.
+ */
+void processLevers(ControllerSnapshot &snapshot)
+{
+    PROFILE_SCOPE(PROFILE_PROCESS_LEVERS);
+    AdcFrame frame;
+    bool moved = false;
+
+    // Consume all frames sampled in the background since the last cycle
+    while (adcSource.readFrame(frame))
+    {
+        if (leversCalibrated)
+        {
+            // Update all levers positions and recognize if any lever position has changed
+            if (levers.update(frame))
+                moved = true;
+        }
+        else
+        {
+            // Calibrate all levers, the flag is set once enough frames were collected
+            LeverCalibration calibration;
+            if (calibrateLevers(frame, calibration))
+            {
+                levers.calibrate(calibration);
+                leversCalibrated = true;
+
+                // Send the calibrated positions right away instead of waiting for the keepalive
+                moved = true;
+            }
+        }
+
+        snapshot.timestampUs = frame.timestampUs;
+    }
+
+    // Learn the reachable lever limits for the next calibration
+    if (leversCalibrated)
+    {
+        uint16_t averages[LEVERS_COUNT];
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+            averages[i] = levers.average(i);
+        learnLeverLimits(averages);
+    }
+
+    // Update the last user activity time if any lever position has changed
+    if (moved)
+    {
+        anyLeverMoved = true;
+        lastUserActivityTime = millis();
+        powerModeWake();
+    }
+
+    // Get the positions of all levers
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        snapshot.data.leverPositions[i] = levers.position(i);
+}
+
+/**
+ * @brief Adds the lever positions of the snapshot to the history if they come from a new ADC frame.
+ *
+ * @param history The history to update.
+ * @param snapshot The snapshot of the current cycle.
+ */
+void updateLeverHistory(LeverHistory &history, const ControllerSnapshot &snapshot)
+{
+    uint8_t newest = (history.head + LEVER_HISTORY_SIZE - 1) % LEVER_HISTORY_SIZE;
+    if (!leversCalibrated || (history.count && history.samples[newest].timestampUs == snapshot.timestampUs))
+        return;
+
+    LeverSample &sample = history.samples[history.head];
+    sample.timestampUs = snapshot.timestampUs;
+    memcpy(sample.leverPositions, snapshot.data.leverPositions, sizeof(sample.leverPositions));
+
+    history.head = (history.head + 1) % LEVER_HISTORY_SIZE;
+    if (history.count < LEVER_HISTORY_SIZE)
+        history.count++;
+
+    leverHistory.write(history);
+}
+
+/**
+ * @brief Updates the timing statistics of the sampling task.
+ *
+ * @param stats The statistics to update.
+ * @param periodUs Time since the start of the previous cycle in microseconds.
+ * @param nominalUs Nominal period of the previous cycle in microseconds (longer in the idle power mode).
+ * @param processUs Time spent processing the current cycle in microseconds.
+ */
+void updateSamplingStats(SamplingStats &stats, uint32_t periodUs, uint32_t nominalUs, uint32_t processUs)
+{
+    uint32_t jitterUs = abs((int32_t)periodUs - (int32_t)nominalUs);
+
+    stats.cycles++;
+    // Exponential moving averages with a weight of 1/16 for the new value
+    stats.avgPeriodUs = stats.avgPeriodUs ? stats.avgPeriodUs + ((int32_t)periodUs - (int32_t)stats.avgPeriodUs) / 16 : periodUs;
+    stats.avgJitterUs += ((int32_t)jitterUs - (int32_t)stats.avgJitterUs) / 16;
+    stats.maxJitterUs = max(stats.maxJitterUs, jitterUs);
+    stats.maxProcessUs = max(stats.maxProcessUs, processUs);
+    if (processUs > SAMPLING_INTERVAL_US)
+        stats.overruns++;
+}
+
+/**
+ * @brief Task sampling the levers at a fixed rate and publishing the controller data.
+ *
+ * @param pvParameters A pointer to task parameters (not used in this function).
+ */
+void samplingTask(void *pvParameters)
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    ControllerSnapshot snapshot = {};
+    LeverHistory history = {};
+    SamplingStats stats = {};
+    int64_t lastCycleStart = 0;
+    TickType_t period = pdMS_TO_TICKS(1000 / LEVER_SAMPLING_RATE_HZ);
+
+    LOG_INFO("samplingTask started");
+
+    for (;;)
+    {
+        int64_t cycleStart = esp_timer_get_time();
+        {
+            PROFILE_SCOPE(PROFILE_SAMPLING_CYCLE);
+
+            processLevers(snapshot);
+
+            // Buttons states and battery voltage are updated by the control and housekeeping tasks
+            memcpy(snapshot.data.buttonsStates, dataToSend.buttonsStates, sizeof(snapshot.data.buttonsStates));
+            bool batteryChanged = snapshot.data.battery != dataToSend.battery;
+            snapshot.data.battery = dataToSend.battery;
+
+            controllerSnapshot.write(snapshot);
+            updateLeverHistory(history, snapshot);
+
+            // The display shows the published battery voltage
+            if (batteryChanged)
+                notifyDisplay(DISPLAY_EVENT_BATTERY);
+        }
+
+        // Measure the time from the ADC frame to publishing its lever positions
+        if (snapshot.timestampUs)
+        {
+            uint32_t publishLatencyUs = (uint32_t)esp_timer_get_time() - snapshot.timestampUs;
+            stats.avgPublishLatencyUs += ((int32_t)publishLatencyUs - (int32_t)stats.avgPublishLatencyUs) / 16;
+            stats.maxPublishLatencyUs = max(stats.maxPublishLatencyUs, publishLatencyUs);
+        }
+
+        if (lastCycleStart)
+        {
+            updateSamplingStats(stats, cycleStart - lastCycleStart, period * portTICK_PERIOD_MS * 1000,
+                                esp_timer_get_time() - cycleStart);
+            stats.emitted = levers.emittedCount();
+            stats.suppressed = levers.suppressedCount();
+            samplingStats.write(stats);
+        }
+        lastCycleStart = cycleStart;
+
+        // Sample less often in the idle power mode
+        period = powerModePeriod(pdMS_TO_TICKS(1000 / LEVER_SAMPLING_RATE_HZ));
+        xTaskDelayUntil(&xLastWakeTime, period);
+    }
+}
+
+/**
+ * @brief Initializes the sampling task.
+ *
+ * The task publishes the controller data from the very beginning, the lever positions stay zero
+ * until the lever sampling is started with startLeverSampling().
+ *
+ * @note This function should be called once during the setup phase of the program.
+ */
+void samplingTaskInit(void)
+{
+    if (pdPASS != xTaskCreatePinnedToCore(samplingTask,
+                                          "samplingTask",
+                                          SAMPLING_TASK_STACK_SIZE,
+                                          NULL,
+                                          SAMPLING_TASK_PRIORITY,
+                                          NULL,
+                                          SAMPLING_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create samplingTask");
+    }
+}
+
+/**
+ * @brief Starts the ADC sampling of all levers. The first frames are used for calibration.
+ *
+ * @note Potentiometers must be powered before calling this function.
+ */
+void startLeverSampling(void)
+{
+    // Load the stored calibration before the first frame arrives
+    loadLeverCalibration();
+
+    uint8_t leverPins[LEVERS_COUNT];
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        leverPins[i] = levers.getPin(i);
+
+    if (!adcSource.begin(leverPins, LEVERS_COUNT))
+        LOG_ERROR("Failed to start lever sampling");
+}
+
+/**
+ * @brief Returns a consistent copy of the latest controller data.
+ */
+ControllerSnapshot readControllerSnapshot(void)
+{
+    return controllerSnapshot.read();
+}
+
+/**
+ * @brief Copies the latest lever samples taken before the given time.
+ *
+ * @param beforeUs Only samples older than this time in microseconds are copied.
+ * @param samples The buffer for the samples, newest first.
+ * @param maxCount The size of the buffer.
+ * @return The number of the copied samples.
+ */
+uint8_t readLeverHistory(uint32_t beforeUs, LeverSample *samples, uint8_t maxCount)
+{
+    LeverHistory history = leverHistory.read();
+    uint8_t count = 0;
+
+    for (uint8_t i = 1; i <= history.count && count < maxCount; i++)
+    {
+        const LeverSample &sample = history.samples[(history.head + LEVER_HISTORY_SIZE - i) % LEVER_HISTORY_SIZE];
+        if ((int32_t)(beforeUs - sample.timestampUs) > 0)
+            samples[count++] = sample;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Returns a consistent copy of the sampling task timing statistics.
+ */
+SamplingStats getSamplingStats(void)
+{
+    return samplingStats.read();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file sampling_task.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef SAMPLING_TASK_H
+#define SAMPLING_TASK_H
+
+#include <stdint.h>
+#include <atomic>
+
+#include "data_structures.h"
+#include "wire_format.h"
+
+// Number of the latest lever samples kept for the streaming (v3) frames
+#define LEVER_HISTORY_SIZE (WIRE_V3_HISTORY_MAX + 1)
+
+// Controller data published by the sampling task
+struct ControllerSnapshot
+{
+    uint32_t timestampUs;        // Time of the ADC frame the lever positions were calculated from
+    controller_data_struct data; // Data to be sent to the Excavator
+};
+
+// Timing statistics of the sampling task
+struct SamplingStats
+{
+    uint32_t cycles;              // Number of completed sampling cycles
+    uint32_t avgPeriodUs;         // Average period between cycles in microseconds
+    uint32_t avgJitterUs;         // Average deviation from the nominal period in microseconds
+    uint32_t maxJitterUs;         // Maximum deviation from the nominal period in microseconds
+    uint32_t maxProcessUs;        // Longest processing time of one cycle in microseconds
+    uint32_t overruns;            // Cycles that took longer than the sampling interval
+    uint32_t emitted;             // Lever position changes reported as movement
+    uint32_t suppressed;          // Lever position changes suppressed by the hysteresis
+    uint32_t avgPublishLatencyUs; // Average time from the ADC frame to publishing the snapshot in microseconds
+    uint32_t maxPublishLatencyUs; // Maximum time from the ADC frame to publishing the snapshot in microseconds
+};
+
+// Set by the sampling task when any lever position has changed, cleared by the sender
+extern std::atomic<bool> anyLeverMoved;
+
+void samplingTaskInit(void);
+void startLeverSampling(void);
+ControllerSnapshot readControllerSnapshot(void);
+uint8_t readLeverHistory(uint32_t beforeUs, LeverSample *samples, uint8_t maxCount);
+SamplingStats getSamplingStats(void);
+
+#endif // SAMPLING_TASK_H
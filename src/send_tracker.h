@@ -0,0 +1,147 @@
+/**
+ * @file send_tracker.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef SEND_TRACKER_H
+#define SEND_TRACKER_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Consecutive timeouts with ignored completions after which the missing completions are written off
+#define SEND_TRACKER_RESYNC_TIMEOUTS 3
+
+/**
+ * @brief Tracks the frame in flight and matches the send callbacks to it.
+ *
+ * Every frame accepted by the transport gets a generation number, the send callback counts the
+ * completions. The transport completes the frames in the order they were sent, so a late completion
+ * of a frame that has already timed out has an older generation than the frame in flight and is
+ * ignored instead of ending the newer frame. A completion dropped by the transport (e.g. on its
+ * restart) would make every following completion look late, so once SEND_TRACKER_RESYNC_TIMEOUTS
+ * frames in a row time out although completions came during their flight, the missing ones are
+ * written off.
+ *
+ * complete() is called from the send callback, all other methods only from the sending task.
+ * Has no dependency on the ESP32, so the sending policy can be tested on a development machine.
+ */
+class SendTracker
+{
+private:
+    // Written only by the send callback
+    std::atomic<uint32_t> completedGeneration{0}; // Number of completions
+    std::atomic<uint32_t> completedUs{0};         // Time of the last completion in microseconds
+    std::atomic<bool> completedDelivered{false};  // Delivery status of the last completion
+
+    // Written only by the sending task
+    uint32_t sentGeneration = 0;   // Generation of the last frame accepted by the transport
+    uint32_t lostCompletions = 0;  // Completions written off as lost
+    uint32_t sentUs = 0;           // Time the frame in flight was passed to the transport
+    uint32_t staleCompletions = 0; // Ignored late completions
+    uint8_t staleTimeouts = 0;     // Consecutive timeouts of frames with ignored completions in flight
+    bool staleInFlight = false;    // A completion was ignored while the frame in flight was waiting
+    bool inFlight = false;
+
+    /**
+     * @brief Returns the number of frames accepted by the transport without a completion yet.
+     */
+    uint32_t outstanding() const
+    {
+        return sentGeneration - (completedGeneration.load(std::memory_order_acquire) + lostCompletions);
+    }
+
+public:
+    /**
+     * @brief Registers a frame accepted by the transport as the frame in flight.
+     */
+    void frameSent(uint32_t nowUs)
+    {
+        sentGeneration++;
+        sentUs = nowUs;
+        staleInFlight = false;
+        inFlight = true;
+    }
+
+    /**
+     * @brief Registers the completion of the oldest frame sent (called from the send callback).
+     */
+    void complete(bool delivered, uint32_t nowUs)
+    {
+        completedUs.store(nowUs, std::memory_order_relaxed);
+        completedDelivered.store(delivered, std::memory_order_relaxed);
+        completedGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Takes the completion of the frame in flight after the send callback has signaled one.
+     *
+     * @param delivered Delivery status of the frame.
+     * @param doneUs Time of the completion in microseconds.
+     * @return True if the frame in flight is completed, false if only older frames completed.
+     */
+    bool takeCompletion(bool &delivered, uint32_t &doneUs)
+    {
+        if (!inFlight || (int32_t)outstanding() > 0)
+        {
+            staleCompletions++;
+            staleInFlight |= inFlight;
+            return false;
+        }
+
+        staleTimeouts = 0;
+        delivered = completedDelivered.load(std::memory_order_relaxed);
+        doneUs = completedUs.load(std::memory_order_relaxed);
+        inFlight = false;
+        return true;
+    }
+
+    /**
+     * @brief Gives up the frame in flight if it isn't completed within the timeout.
+     *
+     * @return True if the frame in flight has timed out now.
+     */
+    bool checkTimeout(uint32_t nowUs, uint32_t timeoutUs)
+    {
+        if (!inFlight || nowUs - sentUs < timeoutUs)
+            return false;
+
+        inFlight = false;
+
+        // Completions keep coming but never match, the earlier ones were lost and will never come
+        staleTimeouts = staleInFlight ? staleTimeouts + 1 : 0;
+        if (staleTimeouts >= SEND_TRACKER_RESYNC_TIMEOUTS)
+        {
+            lostCompletions += outstanding();
+            staleTimeouts = 0;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the time left until the frame in flight times out, 0 if no frame is in flight.
+     */
+    uint32_t remainingUs(uint32_t nowUs, uint32_t timeoutUs) const
+    {
+        if (!inFlight || nowUs - sentUs >= timeoutUs)
+            return 0;
+        return timeoutUs - (nowUs - sentUs);
+    }
+
+    bool isInFlight() const
+    {
+        return inFlight;
+    }
+
+    uint32_t staleCount() const
+    {
+        return staleCompletions;
+    }
+};
+
+#endif // SEND_TRACKER_H
@@ -0,0 +1,98 @@
+/**
+ * @file seqlock.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <atomic>
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+// Number of failed read attempts before the reader yields to let a preempted writer finish
+#define SEQLOCK_SPIN_RETRIES 8
+
+/**
+ * @brief Sequence lock for publishing a value from one writer to any number of readers.
+ *
+ * The writer never waits. Readers retry until they get a copy that was not modified while it was being
+ * copied, so they never see a torn value. Intended for small, trivially copyable structures.
+ *
+ * A reader may preempt a lower priority writer on the same core in the middle of a write. Spinning
+ * would then never end, so after SEQLOCK_SPIN_RETRIES failed attempts the reader blocks for a tick
+ * and the writer can complete the write.
+ *
+ * @tparam T Type of the published value.
+ */
+template <typename T>
+class SeqLock
+{
+private:
+    std::atomic<uint32_t> sequence{0}; // Odd while a write is in progress
+    T value{};
+
+public:
+    /**
+     * @brief Publishes a new value (only one writer is allowed).
+     */
+    void write(const T &newValue)
+    {
+        uint32_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value = newValue;
+        std::atomic_thread_fence(std::memory_order_release);
+        sequence.store(current + 2, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns a consistent copy of the last published value.
+     *
+     * @note May block for a tick, so it must not be called from an ISR or a critical section.
+     */
+    T read() const
+    {
+        T copy;
+        uint32_t before, after;
+
+        for (uint32_t attempt = 1;; attempt++)
+        {
+            before = sequence.load(std::memory_order_acquire);
+            copy = value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+            if (!(before & 1) && before == after)
+                return copy;
+
+            if (attempt % SEQLOCK_SPIN_RETRIES == 0)
+            {
+#ifdef ESP_PLATFORM
+                vTaskDelay(1);
+#else
+                std::this_thread::yield();
+#endif
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of completed writes.
+     */
+    uint32_t version() const
+    {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,89 @@
+/**
+ * @file serial_console.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "serial_console.h"
+
+#include <Arduino.h>
+
+#include "profiler.h"
+
+// Longest accepted command line, longer lines are discarded
+#define SERIAL_COMMAND_MAX_LENGTH 32
+
+void printHelp()
+{
+    Serial.println("Commands:\n"
+                   "  prof       - dump the hot path timing histograms\n"
+                   "  prof reset - clear the hot path timing histograms\n"
+                   "  help       - print this help");
+}
+
+struct SerialCommand
+{
+    const char *name;
+    void (*handler)();
+};
+
+static const SerialCommand commands[] = {
+    {"prof", profilerDump},
+    {"prof reset", profilerReset},
+    {"help", printHelp},
+};
+
+/**
+ * @brief Executes a complete command line.
+ */
+void executeCommand(const char *line)
+{
+    for (const SerialCommand &command : commands)
+    {
+        if (!strcmp(line, command.name))
+        {
+            command.handler();
+            return;
+        }
+    }
+
+    Serial.printf("Unknown command: %s\n", line);
+    printHelp();
+}
+
+/**
+ * @brief Reads the received characters without blocking and executes complete command lines.
+ */
+void handleSerialCommands(void)
+{
+    static char line[SERIAL_COMMAND_MAX_LENGTH + 1];
+    static uint8_t length = 0;
+    static bool overflow = false;
+
+    while (Serial.available())
+    {
+        char c = Serial.read();
+
+        if (c == '\r' || c == '\n')
+        {
+            if (length && !overflow)
+            {
+                line[length] = '\0';
+                executeCommand(line);
+            }
+            length = 0;
+            overflow = false;
+        }
+        else if (length < SERIAL_COMMAND_MAX_LENGTH)
+        {
+            line[length++] = c;
+        }
+        else
+        {
+            overflow = true;
+        }
+    }
+}
@@ -0,0 +1,15 @@
+/**
+ * @file serial_console.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+void handleSerialCommands(void);
+
+#endif // SERIAL_CONSOLE_H
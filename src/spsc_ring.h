@@ -0,0 +1,88 @@
+/**
+ * @file spsc_ring.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * @brief Lock-free ring buffer for exactly one producer and one consumer.
+ *
+ * The producer and the consumer may live in different tasks, cores or in an ISR. When the buffer is full,
+ * new items are dropped and counted as overruns, so the producer never blocks.
+ *
+ * @tparam T Type of the stored items (copied by value).
+ * @tparam Size Capacity of the buffer, must be a power of two.
+ */
+template <typename T, size_t Size>
+class SpscRing
+{
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "SpscRing size must be a power of two");
+
+private:
+    T items[Size];
+    std::atomic<uint32_t> head{0};     // Next slot to write, owned by the producer
+    std::atomic<uint32_t> tail{0};     // Next slot to read, owned by the consumer
+    std::atomic<uint32_t> overruns{0}; // Number of items dropped because the buffer was full
+
+public:
+    /**
+     * @brief Adds an item to the buffer (producer side).
+     * @return True if the item was stored, false if the buffer was full.
+     */
+    bool push(const T &item)
+    {
+        uint32_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead - tail.load(std::memory_order_acquire) >= Size)
+        {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        items[currentHead & (Size - 1)] = item;
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest item from the buffer (consumer side).
+     * @return True if an item was read, false if the buffer was empty.
+     */
+    bool pop(T &item)
+    {
+        uint32_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail == head.load(std::memory_order_acquire))
+            return false;
+
+        item = items[currentTail & (Size - 1)];
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of items waiting in the buffer.
+     */
+    uint32_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the number of items dropped because the buffer was full.
+     */
+    uint32_t overrunCount() const
+    {
+        return overruns.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,114 @@
+/**
+ * @file synthetic_adc_source.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef SYNTHETIC_ADC_SOURCE_H
+#define SYNTHETIC_ADC_SOURCE_H
+
+#include <stdint.h>
+
+#include "adc_sampler.h"
+#include "constants.h"
+
+// Maximum value of the 10-bit frame samples
+#define SYNTHETIC_ADC_MAX 1023
+
+/**
+ * @brief ADC source generating frames from programmed channel levels with pseudo-random noise.
+ *
+ * Frames are produced on demand, one per ADC_FRAME_INTERVAL_MS of simulated time, so the consumers
+ * can be driven faster than real time. Has no dependency on the ESP32, intended for tests and the
+ * simulation tools on a development machine.
+ */
+class SyntheticAdcSource : public AdcSource
+{
+private:
+    uint8_t channelMask = 0;                  // Bit mask of the sampled ADC1 channels
+    uint16_t levels[ADC_FRAME_CHANNELS] = {}; // Noise-free values of the channels
+    uint16_t noise = 0;                       // Maximum noise amplitude added to the samples
+    uint32_t randomState = 1;                 // State of the noise generator
+    uint32_t timestampUs = 0;                 // Timestamp of the last generated frame
+    uint32_t availableFrames = 0;             // Frames elapsed but not read yet
+
+    /**
+     * @brief Returns a pseudo-random noise sample in the range of -noise to noise.
+     */
+    int32_t nextNoise()
+    {
+        randomState = randomState * 1664525UL + 1013904223UL;
+        return noise ? (int32_t)((randomState >> 16) % (2 * noise + 1)) - noise : 0;
+    }
+
+public:
+    bool begin(const uint8_t *pins, uint8_t count) override
+    {
+        channelMask = 0;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            int8_t channel = adc1Channel(pins[i]);
+            if (channel < 0)
+                return false;
+            channelMask |= 1 << channel;
+            levels[channel] = SYNTHETIC_ADC_MAX / 2;
+        }
+        return true;
+    }
+
+    bool readFrame(AdcFrame &frame) override
+    {
+        if (!availableFrames)
+            return false;
+        availableFrames--;
+
+        timestampUs += ADC_FRAME_INTERVAL_MS * 1000;
+        frame.timestampUs = timestampUs;
+        frame.conversions = ADC_SAMPLE_FREQ_HZ / LEVER_SAMPLING_RATE_HZ / LEVERS_COUNT;
+        for (uint8_t channel = 0; channel < ADC_FRAME_CHANNELS; channel++)
+        {
+            int32_t sample = 0;
+            if (channelMask & (1 << channel))
+                sample = levels[channel] + nextNoise();
+            frame.samples[channel] = sample < 0 ? 0 : sample > SYNTHETIC_ADC_MAX ? SYNTHETIC_ADC_MAX : sample;
+        }
+        return true;
+    }
+
+    uint32_t overrunCount() const override
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Sets the noise-free value of an analog pin.
+     */
+    void setLevel(uint8_t pin, uint16_t level)
+    {
+        int8_t channel = adc1Channel(pin);
+        if (channel >= 0)
+            levels[channel] = level;
+    }
+
+    /**
+     * @brief Sets the maximum noise amplitude and restarts the noise sequence with the seed.
+     */
+    void setNoise(uint16_t amplitude, uint32_t seed = 1)
+    {
+        noise = amplitude;
+        randomState = seed;
+    }
+
+    /**
+     * @brief Advances the simulated time by the given number of frame intervals.
+     */
+    void advance(uint32_t frames)
+    {
+        availableFrames += frames;
+    }
+};
+
+#endif // SYNTHETIC_ADC_SOURCE_H
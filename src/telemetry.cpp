@@ -0,0 +1,155 @@
+/**
+ * @file telemetry.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "telemetry.h"
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#include "constants.h"
+#include "display.h"
+#include "leds.h"
+#include "logger.h"
+#include "rtt_stats.h"
+#include "seqlock.h"
+#include "spsc_ring.h"
+#include "wire_format.h"
+
+// Task parameters
+#define TELEMETRY_TASK_STACK_SIZE (4 * 1024U)
+#define TELEMETRY_TASK_PRIORITY   (tskIDLE_PRIORITY + 2)
+#define TELEMETRY_TASK_CORE       1 // Core 0 is used by the WiFi
+
+// Raw frame copied by the receive callback
+struct ReceivedFrame
+{
+    uint32_t timestampUs; // Time the frame was received in microseconds
+    uint8_t length;       // Length of the frame in bytes
+    uint8_t data[TELEMETRY_FRAME_MAX_SIZE];
+};
+
+// Frames passed from the receive callback (WiFi task) to the telemetry task
+SpscRing<ReceivedFrame, TELEMETRY_RX_BUFFER_SIZE> receivedFrames;
+TaskHandle_t telemetryTaskHandle = NULL;
+
+// Counters of the receive callback
+std::atomic<uint32_t> framesReceived{0};
+std::atomic<uint32_t> framesInvalid{0};
+uint32_t framesProcessed = 0;
+
+SeqLock<TelemetrySnapshot> telemetrySnapshot;
+
+/**
+ * @brief Callback when data from the Excavator received.
+ *
+ * Runs in the context of the WiFi task, so it only copies the frame into the ring buffer and wakes
+ * up the telemetry task.
+ */
+void telemetryReceive(const uint8_t *mac, const uint8_t *data, int len)
+{
+    if (len <= 0 || len > TELEMETRY_FRAME_MAX_SIZE)
+    {
+        framesInvalid++;
+        return;
+    }
+
+    ReceivedFrame frame;
+    frame.timestampUs = esp_timer_get_time();
+    frame.length = len;
+    memcpy(frame.data, data, len);
+
+    if (!receivedFrames.push(frame))
+        return; // Counted as an overrun by the ring buffer
+
+    framesReceived++;
+    if (telemetryTaskHandle)
+        xTaskNotifyGive(telemetryTaskHandle);
+}
+
+/**
+ * @brief Decodes a frame from the Excavator and publishes its data.
+ */
+void processTelemetryFrame(const ReceivedFrame &frame)
+{
+    TelemetrySnapshot snapshot;
+    snapshot.receivedUs = frame.timestampUs;
+
+    // Older Excavator firmware sends a shorter structure without the protocol version
+    memset(&snapshot.data, 0, sizeof(snapshot.data));
+    memcpy(&snapshot.data, frame.data, min<size_t>(frame.length, sizeof(snapshot.data)));
+    setPeerProtocolVersion(snapshot.data.protocolVersion);
+
+    // Measure the round-trip time if the Excavator echoes the sequence numbers
+    if (frame.length >= offsetof(excavator_data_struct, echoHoldUs) + sizeof(snapshot.data.echoHoldUs))
+        rttEchoReceived(snapshot.data.echoSequence, snapshot.data.echoHoldUs, frame.timestampUs);
+
+    telemetrySnapshot.write(snapshot);
+    framesProcessed++;
+    notifyDisplay(DISPLAY_EVENT_TELEMETRY);
+
+    LOG_INFO("Received from Excavator | Uptime: %u | Battery: %u | Protocol: v%u",
+             snapshot.data.uptime, snapshot.data.battery, getProtocolVersion());
+
+    // Blink the LED to indicate data received
+    blinkWithLed(LED_BUTTON_B);
+}
+
+/**
+ * @brief Task processing the frames received from the Excavator.
+ *
+ * @param pvParameters A pointer to task parameters (not used in this function).
+ */
+void telemetryTask(void *pvParameters)
+{
+    ReceivedFrame frame;
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (receivedFrames.pop(frame))
+            processTelemetryFrame(frame);
+    }
+}
+
+/**
+ * @brief Initializes the telemetry task.
+ *
+ * @note This function should be called once during the setup phase of the program.
+ */
+void telemetryTaskInit(void)
+{
+    if (pdPASS != xTaskCreatePinnedToCore(telemetryTask,
+                                          "telemetryTask",
+                                          TELEMETRY_TASK_STACK_SIZE,
+                                          NULL,
+                                          TELEMETRY_TASK_PRIORITY,
+                                          &telemetryTaskHandle,
+                                          TELEMETRY_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create telemetryTask");
+    }
+}
+
+/**
+ * @brief Returns a consistent copy of the latest data received from the Excavator.
+ */
+TelemetrySnapshot readTelemetrySnapshot(void)
+{
+    return telemetrySnapshot.read();
+}
+
+/**
+ * @brief Returns the statistics of the receive path.
+ */
+TelemetryStats getTelemetryStats(void)
+{
+    return {framesReceived, framesProcessed, framesInvalid, receivedFrames.overrunCount()};
+}
@@ -0,0 +1,45 @@
+/**
+ * @file telemetry.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+#include "data_structures.h"
+
+// Largest accepted frame from the Excavator in bytes, longer frames are dropped
+#define TELEMETRY_FRAME_MAX_SIZE 32
+// Number of frames buffered between the receive callback and the telemetry task
+#define TELEMETRY_RX_BUFFER_SIZE 8
+
+static_assert(sizeof(excavator_data_struct) <= TELEMETRY_FRAME_MAX_SIZE, "Excavator data must fit into a frame");
+
+// Latest data received from the Excavator
+struct TelemetrySnapshot
+{
+    uint32_t receivedUs;        // Time the frame was received in microseconds, 0 if nothing received yet
+    excavator_data_struct data; // Decoded data, fields missing in frames of older firmware are zero
+};
+
+// Statistics of the receive path
+struct TelemetryStats
+{
+    uint32_t received;  // Frames accepted by the receive callback
+    uint32_t processed; // Frames decoded by the telemetry task
+    uint32_t invalid;   // Frames dropped because of their length
+    uint32_t overruns;  // Frames dropped because the telemetry task didn't keep up
+};
+
+void telemetryTaskInit(void);
+void telemetryReceive(const uint8_t *mac, const uint8_t *data, int len);
+TelemetrySnapshot readTelemetrySnapshot(void);
+TelemetryStats getTelemetryStats(void);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,62 @@
+/**
+ * @file transport.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Result of passing a frame to the transport
+enum TransportStatus : uint8_t
+{
+    TRANSPORT_OK,   // The frame was accepted, the send callback follows
+    TRANSPORT_BUSY, // No buffer available right now, the frame may be retried shortly
+    TRANSPORT_ERROR // The frame was rejected
+};
+
+// Called once for every accepted frame, delivered is false if the peer didn't acknowledge it
+typedef void (*TransportSendCallback)(bool delivered);
+// Called for every received frame, the MAC address is zero if the transport has none
+typedef void (*TransportReceiveCallback)(const uint8_t *mac, const uint8_t *data, int len);
+
+/**
+ * @brief Link carrying the frames between the Controller and the Excavator.
+ *
+ * The radio task only sees whole frames, so ESP-NOW can be replaced by another link, e.g. UDP
+ * for experiments on a development machine.
+ */
+class Transport
+{
+public:
+    virtual ~Transport() = default;
+
+    /**
+     * @brief Starts the transport and registers the callbacks.
+     * @return True if the transport has started.
+     */
+    virtual bool begin(TransportSendCallback onSent, TransportReceiveCallback onReceived) = 0;
+
+    /**
+     * @brief Returns true if frames can be sent now.
+     */
+    virtual bool isReady() const = 0;
+
+    /**
+     * @brief Sends one frame to the peer without blocking.
+     */
+    virtual TransportStatus send(const uint8_t *data, size_t length) = 0;
+
+    /**
+     * @brief Returns the name of the transport for logs.
+     */
+    virtual const char *name() const = 0;
+};
+
+#endif // TRANSPORT_H
@@ -0,0 +1,147 @@
+/**
+ * @file udp_transport.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "udp_transport.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+UdpTransport::UdpTransport(const char *peerHost, uint16_t peerPort, uint16_t _localPort) : localPort(_localPort)
+{
+    peerAddr.sin_family = AF_INET;
+    peerAddr.sin_port = htons(peerPort);
+    if (inet_pton(AF_INET, peerHost, &peerAddr.sin_addr) != 1)
+        printf("Invalid UDP peer address: %s\n", peerHost);
+}
+
+UdpTransport::~UdpTransport()
+{
+    end();
+}
+
+/**
+ * @brief Receives datagrams until the socket is closed.
+ */
+void *UdpTransport::receiveLoop(void *arg)
+{
+    UdpTransport *transport = static_cast<UdpTransport *>(arg);
+    static const uint8_t noMac[6] = {0};
+    uint8_t buffer[UDP_TRANSPORT_RX_BUFFER_SIZE];
+
+    for (;;)
+    {
+        int fd = transport->sock;
+        if (fd < 0)
+            break;
+
+        ssize_t len = recv(fd, buffer, sizeof(buffer), 0);
+        if (transport->sock < 0)
+            break; // Socket closed by end()
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (transport->receiveCallback)
+            transport->receiveCallback(noMac, buffer, len);
+    }
+
+    return nullptr;
+}
+
+bool UdpTransport::begin(TransportSendCallback onSent, TransportReceiveCallback onReceived)
+{
+    // Restart with the new callbacks if already started
+    end();
+
+    sendCallback = onSent;
+    receiveCallback = onReceived;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        printf("Failed to create UDP socket: %d\n", errno);
+        return false;
+    }
+
+    sockaddr_in localAddr = {};
+    localAddr.sin_family = AF_INET;
+    localAddr.sin_port = htons(localPort);
+    localAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (sockaddr *)&localAddr, sizeof(localAddr)) < 0)
+    {
+        printf("Failed to bind UDP port %u: %d\n", localPort, errno);
+        close(fd);
+        return false;
+    }
+
+    sock = fd;
+    if (pthread_create(&receiveThread, NULL, receiveLoop, this) != 0)
+    {
+        printf("Failed to start UDP receive thread\n");
+        end();
+        return false;
+    }
+    threadStarted = true;
+
+    return true;
+}
+
+/**
+ * @brief Closes the socket and stops the receive thread.
+ */
+void UdpTransport::end()
+{
+    int fd = sock.exchange(-1);
+    if (fd >= 0)
+    {
+        // Wake up the receive thread blocked in recv()
+        shutdown(fd, SHUT_RDWR);
+        close(fd);
+    }
+
+    if (threadStarted)
+    {
+        pthread_join(receiveThread, NULL);
+        threadStarted = false;
+    }
+}
+
+bool UdpTransport::isReady() const
+{
+    return sock >= 0;
+}
+
+TransportStatus UdpTransport::send(const uint8_t *data, size_t length)
+{
+    int fd = sock;
+    if (fd < 0)
+        return TRANSPORT_ERROR;
+
+    ssize_t sent = sendto(fd, data, length, MSG_DONTWAIT, (const sockaddr *)&peerAddr, sizeof(peerAddr));
+    if (sent < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS || errno == ENOMEM)
+            return TRANSPORT_BUSY;
+
+        printf("Error sending UDP datagram: %d\n", errno);
+        return TRANSPORT_ERROR;
+    }
+
+    // Accepted by the network stack, that's the best delivery status UDP can give
+    if (sendCallback)
+        sendCallback(true);
+
+    return TRANSPORT_OK;
+}
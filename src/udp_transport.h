@@ -0,0 +1,59 @@
+/**
+ * @file udp_transport.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef UDP_TRANSPORT_H
+#define UDP_TRANSPORT_H
+
+#include <atomic>
+#include <pthread.h>
+#include <netinet/in.h>
+
+#include "transport.h"
+
+// Default ports of the simulated Excavator and of the Controller
+#define UDP_TRANSPORT_PEER_PORT  4210
+#define UDP_TRANSPORT_LOCAL_PORT 4211
+
+// Size of the receive buffer, larger datagrams are truncated
+#define UDP_TRANSPORT_RX_BUFFER_SIZE 256
+
+/**
+ * @brief Transport sending the frames as UDP datagrams.
+ *
+ * Uses only POSIX sockets and threads, so it runs on a development machine as well as on the ESP32
+ * (lwIP). UDP has no acknowledgements: a frame accepted by the network stack is reported as delivered,
+ * losses show up in the round-trip time statistics instead.
+ */
+class UdpTransport : public Transport
+{
+private:
+    sockaddr_in peerAddr = {};
+    uint16_t localPort;
+    std::atomic<int> sock{-1};
+    pthread_t receiveThread;
+    bool threadStarted = false;
+
+    TransportSendCallback sendCallback = nullptr;
+    TransportReceiveCallback receiveCallback = nullptr;
+
+    static void *receiveLoop(void *arg);
+
+public:
+    UdpTransport(const char *peerHost, uint16_t peerPort = UDP_TRANSPORT_PEER_PORT,
+                 uint16_t localPort = UDP_TRANSPORT_LOCAL_PORT);
+    ~UdpTransport() override;
+
+    bool begin(TransportSendCallback onSent, TransportReceiveCallback onReceived) override;
+    void end();
+    bool isReady() const override;
+    TransportStatus send(const uint8_t *data, size_t length) override;
+    const char *name() const override { return "UDP"; }
+};
+
+#endif // UDP_TRANSPORT_H
@@ -9,23 +9,53 @@
 
 #include "wifi_ota_manager.h"
 #include <WiFi.h>
+#include <esp_wifi.h>
 #include <ArduinoOTA.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <atomic>
 
 #include "constants.h"
 #include "display.h"
 #include "esp_now_interface.h"
+#include "fast_boot.h"
+#include "logger.h"
+#include "profiler.h"
+
+// Task parameters
+#define OTA_TASK_STACK_SIZE (4 * 1024U)
+#define OTA_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+#define OTA_TASK_CORE       0 // Next to the WiFi stack
+
+// Period of the OTA polling in milliseconds
+#define OTA_POLL_INTERVAL_MS 20
+
+// Access point the station was connected to when the radio was paused, rejoined without scanning
+static uint8_t pausedChannel;
+static uint8_t pausedBssid[6];
+static int64_t pausedUs;
+
+// Set by resumeWiFiRadio(), the connection event measures the time since the radio was paused
+static std::atomic<bool> reconnectPending{false};
+static std::atomic<uint32_t> reconnectUs{0};
 
 // Callback function to handle WiFi ready event
 void onWiFiReady(WiFiEvent_t event, WiFiEventInfo_t info)
 {
-    Serial.println("WiFi interface ready");
-    initEspNow();
+    LOG_INFO("WiFi interface ready");
+    initTransport();
 }
 
 // Callback function to handle WiFi connection event
 void onWiFiConnected(WiFiEvent_t event, WiFiEventInfo_t info)
 {
-    Serial.println("Connected to WiFi: " + WiFi.SSID());
+    // Join the same access point without scanning after the next wake-up
+    fastBootSaveAccessPoint(info.wifi_sta_connected.channel, info.wifi_sta_connected.bssid);
+
+    if (reconnectPending.exchange(false))
+        reconnectUs = (uint32_t)(esp_timer_get_time() - pausedUs);
+
+    LOG_FORMATTED(LOG_LEVEL_INFO, "Connected to WiFi: %s", WiFi.SSID().c_str());
 
     // Start Arduino OTA
     ArduinoOTA.begin();
@@ -34,13 +64,13 @@ void onWiFiConnected(WiFiEvent_t event, WiFiEventInfo_t info)
 // Callback function to handle IP address assignment event
 void onWiFiGotIP(WiFiEvent_t event, WiFiEventInfo_t info)
 {
-    Serial.println("Got IP address: " + WiFi.localIP().toString());
+    LOG_FORMATTED(LOG_LEVEL_INFO, "Got IP address: %s", WiFi.localIP().toString().c_str());
 }
 
 // Callback function to handle WiFi disconnection event
 void onWiFiDisconnected(WiFiEvent_t event, WiFiEventInfo_t info)
 {
-    Serial.println("Disconnected from WiFi: " + String(reinterpret_cast<char *>(info.wifi_sta_disconnected.ssid)));
+    LOG_FORMATTED(LOG_LEVEL_INFO, "Disconnected from WiFi: %.32s", reinterpret_cast<char *>(info.wifi_sta_disconnected.ssid));
 }
 
 // Setup Wi-Fi connection
@@ -59,9 +89,17 @@ void setupWiFi()
 
 void enableWiFi()
 {
+    uint8_t channel;
+    uint8_t bssid[6];
+
     // Set device as a Wi-Fi Station
     WiFi.mode(WIFI_AP_STA);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+
+    // Connect to the known access point directly, so ESP-NOW stays on its channel from the start
+    if (isFastBoot() && getFastBootAccessPoint(channel, bssid))
+        WiFi.begin(WIFI_SSID, WIFI_PASSWORD, channel, bssid);
+    else
+        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 }
 
 void disableWiFi()
@@ -75,6 +113,70 @@ bool isWiFiEnabled()
     return WiFi.getMode() != WIFI_OFF;
 }
 
+bool isWiFiConnected()
+{
+    return WiFi.isConnected();
+}
+
+/**
+ * @brief Stops the radio without changing the WiFi mode, so the ADC2 can be used.
+ *
+ * Unlike disableWiFi() the WiFi driver, ESP-NOW and its peers stay initialized. The station is
+ * disconnected though, it has to associate with the access point again after resumeWiFiRadio().
+ *
+ * @return True if the station was connected and has to be reconnected by resumeWiFiRadio().
+ */
+bool pauseWiFiRadio()
+{
+    wifi_ap_record_t accessPoint;
+    bool wasConnected = WiFi.isConnected() && esp_wifi_sta_get_ap_info(&accessPoint) == ESP_OK;
+
+    if (wasConnected)
+    {
+        pausedChannel = accessPoint.primary;
+        memcpy(pausedBssid, accessPoint.bssid, sizeof(pausedBssid));
+        pausedUs = esp_timer_get_time();
+    }
+
+    esp_wifi_stop();
+    return wasConnected;
+}
+
+/**
+ * @brief Starts the radio stopped by pauseWiFiRadio().
+ *
+ * The station joins the same access point on its channel directly, a scan would take the radio
+ * off the ESP-NOW channel for a while.
+ *
+ * @param reconnect Reconnect the station to the access point.
+ */
+void resumeWiFiRadio(bool reconnect)
+{
+    esp_wifi_start();
+    if (!reconnect)
+        return;
+
+    wifi_config_t config;
+    esp_wifi_get_config(WIFI_IF_STA, &config);
+    config.sta.channel = pausedChannel;
+    config.sta.bssid_set = true;
+    memcpy(config.sta.bssid, pausedBssid, sizeof(config.sta.bssid));
+    esp_wifi_set_config(WIFI_IF_STA, &config);
+
+    reconnectPending = true;
+    esp_wifi_connect();
+}
+
+/**
+ * @brief Returns the time from pauseWiFiRadio() until the station was connected again, once.
+ *
+ * @return The time in microseconds, 0 if no reconnection has completed since the last call.
+ */
+uint32_t takeWiFiReconnectUs()
+{
+    return reconnectUs.exchange(0);
+}
+
 // Setup Arduino OTA (Over-The-Air) update
 void setupOTA()
 {
@@ -84,7 +186,7 @@ void setupOTA()
 
     // Callback functions for OTA events
     ArduinoOTA.onStart([]()
-                       { Serial.println("OTA update started");
+                       { LOG_INFO("OTA update started");
                        setDisplayState(DISPLAY_OTA_UPDATE); });
     // Blink with the built-in LED while updating
     ArduinoOTA.onProgress([](unsigned int progress, unsigned int total)
@@ -92,10 +194,44 @@ void setupOTA()
     // Turn off the built-in LED when update is finished
     ArduinoOTA.onEnd([]()
                      { digitalWrite(STATUS_LED, LOW);
-                        Serial.println("OTA update finished"); });
+                        LOG_INFO("OTA update finished"); });
 }
 
 void handleOTA()
 {
+    PROFILE_SCOPE(PROFILE_HANDLE_OTA);
     ArduinoOTA.handle();
+}
+
+/**
+ * @brief Task polling the OTA updates.
+ *
+ * @param pvParameters A pointer to task parameters (not used in this function).
+ */
+void otaTask(void *pvParameters)
+{
+    for (;;)
+    {
+        handleOTA();
+        vTaskDelay(pdMS_TO_TICKS(OTA_POLL_INTERVAL_MS));
+    }
+}
+
+/**
+ * @brief Initializes the OTA task.
+ *
+ * @note This function should be called once during the setup phase of the program.
+ */
+void otaTaskInit()
+{
+    if (pdPASS != xTaskCreatePinnedToCore(otaTask,
+                                          "otaTask",
+                                          OTA_TASK_STACK_SIZE,
+                                          NULL,
+                                          OTA_TASK_PRIORITY,
+                                          NULL,
+                                          OTA_TASK_CORE))
+    {
+        LOG_ERROR("Failed to create otaTask");
+    }
 }
\ No newline at end of file
@@ -10,11 +10,18 @@
 #ifndef WIFI_OTA_MANAGER_H
 #define WIFI_OTA_MANAGER_H
 
+#include <stdint.h>
+
 void setupWiFi();
 void enableWiFi();
 void disableWiFi();
 bool isWiFiEnabled();
+bool isWiFiConnected();
+bool pauseWiFiRadio();
+void resumeWiFiRadio(bool reconnect);
+uint32_t takeWiFiReconnectUs();
 void setupOTA();
 void handleOTA();
+void otaTaskInit();
 
 #endif // WIFI_OTA_MANAGER_H
\ No newline at end of file
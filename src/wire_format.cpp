@@ -0,0 +1,374 @@
+/**
+ * @file wire_format.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include "wire_format.h"
+
+#include <string.h>
+
+// Negotiated protocol version and sequence number of the next sent frame
+static volatile uint8_t protocolVersion = WIRE_PROTOCOL_LEGACY;
+static uint8_t txSequence = 0;
+
+// Writes fields of arbitrary width into a zeroed buffer, least significant bit first
+class BitWriter
+{
+private:
+    uint8_t *buffer;
+    size_t bitPos = 0;
+
+public:
+    explicit BitWriter(uint8_t *_buffer) : buffer(_buffer) {}
+
+    size_t position() const { return bitPos; }
+
+    void write(uint32_t value, uint8_t bits)
+    {
+        for (uint8_t i = 0; i < bits; i++, bitPos++)
+        {
+            if (value & (1UL << i))
+                buffer[bitPos / 8] |= 1 << (bitPos % 8);
+        }
+    }
+};
+
+// Reads fields written by BitWriter
+class BitReader
+{
+private:
+    const uint8_t *buffer;
+    size_t bitPos = 0;
+
+public:
+    explicit BitReader(const uint8_t *_buffer) : buffer(_buffer) {}
+
+    size_t position() const { return bitPos; }
+
+    uint32_t read(uint8_t bits)
+    {
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < bits; i++, bitPos++)
+        {
+            if (buffer[bitPos / 8] & (1 << (bitPos % 8)))
+                value |= 1UL << i;
+        }
+        return value;
+    }
+
+    int32_t readSigned(uint8_t bits)
+    {
+        if (!bits)
+            return 0;
+
+        uint32_t value = read(bits);
+        // Sign-extend the value
+        if (value & (1UL << (bits - 1)))
+            value |= ~((1UL << bits) - 1);
+        return (int32_t)value;
+    }
+};
+
+/**
+ * @brief Calculates CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+ */
+uint16_t crc16(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Writes the fields shared by the v2 and v3 frames.
+ */
+static void writeV2Fields(BitWriter &writer, uint8_t version, const WireHeader &header, const controller_data_struct &data)
+{
+    writer.write(version, WIRE_V2_VERSION_BITS);
+    writer.write(header.flags, WIRE_V2_FLAGS_BITS);
+    writer.write(header.sequence, WIRE_V2_SEQUENCE_BITS);
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        writer.write((uint32_t)data.leverPositions[i], WIRE_V2_LEVER_BITS);
+
+    for (uint8_t i = 0; i < BUTTONS_COUNT; i++)
+        writer.write(data.buttonsStates[i], WIRE_V2_BUTTON_BITS);
+
+    // Battery voltage in steps above the base voltage, saturated to the field range
+    int32_t battery = ((int32_t)data.battery - WIRE_V2_BATTERY_BASE_MV) / WIRE_V2_BATTERY_STEP_MV;
+    battery = battery < 0 ? 0 : battery > (1 << WIRE_V2_BATTERY_BITS) - 1 ? (1 << WIRE_V2_BATTERY_BITS) - 1 : battery;
+    writer.write(battery, WIRE_V2_BATTERY_BITS);
+}
+
+/**
+ * @brief Reads the fields shared by the v2 and v3 frames following the version field.
+ */
+static void readV2Fields(BitReader &reader, WireHeader &header, controller_data_struct &data)
+{
+    header.flags = reader.read(WIRE_V2_FLAGS_BITS);
+    header.sequence = reader.read(WIRE_V2_SEQUENCE_BITS);
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        data.leverPositions[i] = reader.readSigned(WIRE_V2_LEVER_BITS);
+
+    for (uint8_t i = 0; i < BUTTONS_COUNT; i++)
+        data.buttonsStates[i] = reader.read(WIRE_V2_BUTTON_BITS);
+
+    data.battery = reader.read(WIRE_V2_BATTERY_BITS) * WIRE_V2_BATTERY_STEP_MV + WIRE_V2_BATTERY_BASE_MV;
+}
+
+/**
+ * @brief Appends the CRC in big-endian byte order after the payload.
+ *
+ * @return The size of the frame in bytes.
+ */
+static size_t appendCrc(uint8_t *buffer, size_t payloadSize)
+{
+    uint16_t crc = crc16(buffer, payloadSize);
+    buffer[payloadSize] = crc >> 8;
+    buffer[payloadSize + 1] = crc & 0xFF;
+
+    return payloadSize + WIRE_V2_CRC_BITS / 8;
+}
+
+/**
+ * @brief Returns the number of bits needed to store the value as a signed field.
+ */
+static uint8_t signedWidth(int32_t value)
+{
+    uint8_t bits = 0;
+    while (value < -(1L << bits) / 2 || value > ((1L << bits) - 1) / 2)
+        bits++;
+    return bits;
+}
+
+/**
+ * @brief Encodes the controller data into a bit-packed v2 frame.
+ *
+ * @param data The controller data.
+ * @param header The frame header, the version field is ignored.
+ * @param buffer The buffer for the frame, at least WIRE_V2_FRAME_SIZE bytes.
+ * @return The size of the frame in bytes.
+ */
+size_t encodeControllerFrameV2(const controller_data_struct &data, const WireHeader &header, uint8_t *buffer)
+{
+    memset(buffer, 0, WIRE_V2_FRAME_SIZE);
+    BitWriter writer(buffer);
+
+    writeV2Fields(writer, WIRE_PROTOCOL_V2, header, data);
+
+    return appendCrc(buffer, WIRE_V2_PAYLOAD_SIZE);
+}
+
+/**
+ * @brief Encodes the controller data and the previous lever samples into a v3 frame.
+ *
+ * @param data The controller data.
+ * @param timestampUs Time the lever positions of the data were sampled at in microseconds.
+ * @param header The frame header, the version field is ignored.
+ * @param history Lever samples older than the data, newest first.
+ * @param historyCount Number of the history samples, at most WIRE_V3_HISTORY_MAX are encoded.
+ * @param buffer The buffer for the frame, at least WIRE_V3_FRAME_MAX_SIZE bytes.
+ * @return The size of the frame in bytes.
+ */
+size_t encodeControllerFrameV3(const controller_data_struct &data, uint32_t timestampUs, const WireHeader &header,
+                               const LeverSample *history, uint8_t historyCount, uint8_t *buffer)
+{
+    if (historyCount > WIRE_V3_HISTORY_MAX)
+        historyCount = WIRE_V3_HISTORY_MAX;
+
+    // Find the width able to hold all deltas between the neighbouring samples
+    uint8_t deltaWidth = 0;
+    const int16_t *newer = data.leverPositions;
+    for (uint8_t s = 0; s < historyCount; s++)
+    {
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        {
+            uint8_t width = signedWidth(history[s].leverPositions[i] - newer[i]);
+            deltaWidth = width > deltaWidth ? width : deltaWidth;
+        }
+        newer = history[s].leverPositions;
+    }
+
+    memset(buffer, 0, WIRE_V3_FRAME_MAX_SIZE);
+    BitWriter writer(buffer);
+
+    writeV2Fields(writer, WIRE_PROTOCOL_V3, header, data);
+    writer.write(historyCount, WIRE_V3_HISTORY_COUNT_BITS);
+    writer.write(deltaWidth, WIRE_V3_DELTA_WIDTH_BITS);
+
+    newer = data.leverPositions;
+    uint32_t newerAge = 0;
+    for (uint8_t s = 0; s < historyCount; s++)
+    {
+        // Ages are quantized relative to the data, so the rounding errors don't accumulate
+        uint32_t age = (timestampUs - history[s].timestampUs + WIRE_V3_SAMPLE_AGE_UNIT_US / 2) / WIRE_V3_SAMPLE_AGE_UNIT_US;
+        uint32_t step = age > newerAge ? age - newerAge : 0;
+        step = step < (1 << WIRE_V3_SAMPLE_AGE_BITS) - 1 ? step : (1 << WIRE_V3_SAMPLE_AGE_BITS) - 1;
+        newerAge += step;
+        writer.write(step, WIRE_V3_SAMPLE_AGE_BITS);
+
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+            writer.write((uint32_t)(history[s].leverPositions[i] - newer[i]), deltaWidth);
+        newer = history[s].leverPositions;
+    }
+
+    // Legacy frames are recognized by their size, so a v3 frame of the same size gets a padding byte
+    size_t payloadSize = (writer.position() + 7) / 8;
+    if (payloadSize + WIRE_V2_CRC_BITS / 8 == sizeof(controller_data_struct))
+        payloadSize++;
+
+    return appendCrc(buffer, payloadSize);
+}
+
+/**
+ * @brief Decodes a controller frame of any supported version.
+ *
+ * Timestamps of the decoded history samples are relative to the frame lever positions, which are
+ * sampled at 0 (older samples have negative timestamps in the modular uint32_t arithmetic).
+ *
+ * @param buffer The received frame.
+ * @param length The length of the received frame in bytes.
+ * @param data The decoded controller data.
+ * @param header The decoded header (legacy frames have no flags and sequence numbers).
+ * @param history The buffer for the decoded history, at least WIRE_V3_HISTORY_MAX samples (optional).
+ * @param historyCount The number of the decoded history samples (optional).
+ * @return True if the frame was valid, false otherwise.
+ */
+bool decodeControllerFrame(const uint8_t *buffer, size_t length, controller_data_struct &data, WireHeader &header,
+                           LeverSample *history, uint8_t *historyCount)
+{
+    if (historyCount)
+        *historyCount = 0;
+
+    if (length == sizeof(controller_data_struct))
+    {
+        memcpy(&data, buffer, sizeof(data));
+        header = {WIRE_PROTOCOL_LEGACY, 0, 0};
+        return true;
+    }
+
+    if (length < WIRE_V2_FRAME_SIZE || length > WIRE_V3_FRAME_MAX_SIZE)
+        return false;
+
+    size_t payloadSize = length - WIRE_V2_CRC_BITS / 8;
+    uint16_t crc = (uint16_t)buffer[payloadSize] << 8 | buffer[payloadSize + 1];
+    if (crc != crc16(buffer, payloadSize))
+        return false;
+
+    BitReader reader(buffer);
+    header.version = reader.read(WIRE_V2_VERSION_BITS);
+    if (header.version == WIRE_PROTOCOL_V2 && length != WIRE_V2_FRAME_SIZE)
+        return false;
+    if (header.version != WIRE_PROTOCOL_V2 && header.version != WIRE_PROTOCOL_V3)
+        return false;
+
+    readV2Fields(reader, header, data);
+
+    if (header.version == WIRE_PROTOCOL_V2)
+        return true;
+
+    uint8_t count = reader.read(WIRE_V3_HISTORY_COUNT_BITS);
+    uint8_t deltaWidth = reader.read(WIRE_V3_DELTA_WIDTH_BITS);
+    if (deltaWidth > WIRE_V3_DELTA_MAX_BITS ||
+        WIRE_V3_HEADER_BITS + count * (WIRE_V3_SAMPLE_AGE_BITS + LEVERS_COUNT * deltaWidth) > payloadSize * 8)
+        return false;
+
+    int16_t newer[LEVERS_COUNT];
+    memcpy(newer, data.leverPositions, sizeof(newer));
+    uint32_t ageUs = 0;
+    for (uint8_t s = 0; s < count; s++)
+    {
+        ageUs += reader.read(WIRE_V3_SAMPLE_AGE_BITS) * WIRE_V3_SAMPLE_AGE_UNIT_US;
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+            newer[i] += reader.readSigned(deltaWidth);
+
+        if (history)
+        {
+            history[s].timestampUs = 0 - ageUs;
+            memcpy(history[s].leverPositions, newer, sizeof(newer));
+        }
+    }
+
+    if (historyCount)
+        *historyCount = count;
+
+    return true;
+}
+
+/**
+ * @brief Encodes the controller data using the negotiated protocol version.
+ *
+ * The frame takes the sequence number of the next sent frame without consuming it, a frame encoded
+ * again after a busy transport keeps its number. Call controllerFrameSent() once it is transmitted.
+ *
+ * @param data The controller data.
+ * @param flags WIRE_FLAG_* bits, ignored by the legacy protocol.
+ * @param buffer The buffer for the frame, at least WIRE_FRAME_MAX_SIZE bytes.
+ * @param header The header the frame was encoded with.
+ * @param timestampUs Time the lever positions of the data were sampled at, used by the v3 protocol.
+ * @param history Lever samples older than the data (newest first), used by the v3 protocol.
+ * @param historyCount Number of the history samples.
+ * @return The size of the frame in bytes.
+ */
+size_t encodeControllerFrame(const controller_data_struct &data, uint8_t flags, uint8_t *buffer, WireHeader &header,
+                             uint32_t timestampUs, const LeverSample *history, uint8_t historyCount)
+{
+    if (protocolVersion < WIRE_PROTOCOL_V2)
+    {
+        header = {WIRE_PROTOCOL_LEGACY, 0, 0};
+        memcpy(buffer, &data, sizeof(data));
+        return sizeof(data);
+    }
+
+    if (protocolVersion < WIRE_PROTOCOL_V3)
+    {
+        header = {WIRE_PROTOCOL_V2, flags, txSequence};
+        return encodeControllerFrameV2(data, header, buffer);
+    }
+
+    header = {WIRE_PROTOCOL_V3, flags, txSequence};
+    return encodeControllerFrameV3(data, timestampUs, header, history, historyCount, buffer);
+}
+
+/**
+ * @brief Advances the sequence number after the frame was handed over to the radio.
+ *
+ * @param header The header the frame was encoded with.
+ */
+void controllerFrameSent(const WireHeader &header)
+{
+    if (header.version >= WIRE_PROTOCOL_V2 && header.sequence == txSequence)
+        txSequence++;
+}
+
+/**
+ * @brief Selects the highest protocol version supported by both sides.
+ *
+ * @param version The protocol version reported by the Excavator (0 if it doesn't report any).
+ */
+void setPeerProtocolVersion(uint8_t version)
+{
+    if (version < WIRE_PROTOCOL_LEGACY)
+        version = WIRE_PROTOCOL_LEGACY;
+    protocolVersion = version < WIRE_PROTOCOL_LATEST ? version : WIRE_PROTOCOL_LATEST;
+}
+
+/**
+ * @brief Returns the negotiated protocol version.
+ */
+uint8_t getProtocolVersion(void)
+{
+    return protocolVersion;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file wire_format.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "data_structures.h"
+
+/*
+ * Wire protocol versions:
+ * 1 - legacy, raw controller_data_struct including the compiler padding
+ * 2 - bit-packed frame with a header, sequence number and CRC
+ * 3 - v2 frame followed by a delta-encoded history of the previous lever samples (streaming mode)
+ *
+ * The controller sends legacy frames until the Excavator reports support of a newer version in
+ * excavator_data_struct.protocolVersion. Legacy frames are told apart by their length, newer frames
+ * by the version field (v3 frames are never as long as the legacy frame).
+ */
+#define WIRE_PROTOCOL_LEGACY 1
+#define WIRE_PROTOCOL_V2     2
+#define WIRE_PROTOCOL_V3     3
+#define WIRE_PROTOCOL_LATEST WIRE_PROTOCOL_V3
+
+// Frame flags (4 bits)
+#define WIRE_FLAG_KEEPALIVE 0x01 // Sent because of the maximum send interval, not because of user input
+#define WIRE_FLAG_POWER_OFF 0x02 // Last frame before the controller powers off, all levers are zero
+
+// Bit widths of the v2 frame fields
+#define WIRE_V2_VERSION_BITS  4
+#define WIRE_V2_FLAGS_BITS    4
+#define WIRE_V2_SEQUENCE_BITS 8
+#define WIRE_V2_LEVER_BITS    11 // Signed, covers the -1023 to 1023 lever range
+#define WIRE_V2_BUTTON_BITS   1
+#define WIRE_V2_BATTERY_BITS  8 // Battery voltage in 10 mV steps above WIRE_V2_BATTERY_BASE_MV
+#define WIRE_V2_CRC_BITS      16
+
+#define WIRE_V2_BATTERY_BASE_MV 2500
+#define WIRE_V2_BATTERY_STEP_MV 10
+
+// Size of the v2 frame payload (everything covered by the CRC) and of the whole frame in bytes
+constexpr size_t WIRE_V2_PAYLOAD_BITS = WIRE_V2_VERSION_BITS + WIRE_V2_FLAGS_BITS + WIRE_V2_SEQUENCE_BITS +
+                                        LEVERS_COUNT * WIRE_V2_LEVER_BITS + BUTTONS_COUNT * WIRE_V2_BUTTON_BITS +
+                                        WIRE_V2_BATTERY_BITS;
+constexpr size_t WIRE_V2_PAYLOAD_SIZE = (WIRE_V2_PAYLOAD_BITS + 7) / 8;
+constexpr size_t WIRE_V2_FRAME_SIZE = WIRE_V2_PAYLOAD_SIZE + WIRE_V2_CRC_BITS / 8;
+
+/*
+ * The v3 frame extends the v2 payload with the history: the number of samples, the width of the lever
+ * deltas and for every sample (newest first) its age relative to the next newer sample followed by
+ * the lever deltas to the next newer sample. The first history sample refers to the frame lever positions.
+ * All deltas of a frame share the smallest width able to hold them, a width of 0 means no movement.
+ */
+#define WIRE_V3_HISTORY_COUNT_BITS 3
+#define WIRE_V3_DELTA_WIDTH_BITS   4
+#define WIRE_V3_SAMPLE_AGE_BITS    8
+#define WIRE_V3_SAMPLE_AGE_UNIT_US 100 // Ages up to 25.5 ms, longer ones are saturated
+#define WIRE_V3_HISTORY_MAX        ((1 << WIRE_V3_HISTORY_COUNT_BITS) - 1)
+#define WIRE_V3_DELTA_MAX_BITS     (WIRE_V2_LEVER_BITS + 1) // Difference of two lever positions
+
+// Size of the largest v3 frame in bytes (one byte may be added to differ from the legacy frame size)
+constexpr size_t WIRE_V3_HEADER_BITS = WIRE_V2_PAYLOAD_BITS + WIRE_V3_HISTORY_COUNT_BITS + WIRE_V3_DELTA_WIDTH_BITS;
+constexpr size_t WIRE_V3_SAMPLE_MAX_BITS = WIRE_V3_SAMPLE_AGE_BITS + LEVERS_COUNT * WIRE_V3_DELTA_MAX_BITS;
+constexpr size_t WIRE_V3_FRAME_MAX_SIZE = (WIRE_V3_HEADER_BITS + WIRE_V3_HISTORY_MAX * WIRE_V3_SAMPLE_MAX_BITS + 7) / 8 +
+                                          1 + WIRE_V2_CRC_BITS / 8;
+
+// Size of the buffer able to hold a frame of any version
+constexpr size_t WIRE_FRAME_MAX_SIZE = sizeof(controller_data_struct) > WIRE_V3_FRAME_MAX_SIZE ? sizeof(controller_data_struct) : WIRE_V3_FRAME_MAX_SIZE;
+
+static_assert(WIRE_V2_FRAME_SIZE < sizeof(controller_data_struct), "v2 frame must be smaller than the legacy frame");
+static_assert(WIRE_V2_FRAME_SIZE <= 250, "v2 frame must fit into a single ESP-NOW packet");
+static_assert(WIRE_V3_FRAME_MAX_SIZE <= 250, "v3 frame must fit into a single ESP-NOW packet");
+static_assert(WIRE_V3_DELTA_MAX_BITS < (1 << WIRE_V3_DELTA_WIDTH_BITS), "Delta width must fit into its field");
+static_assert(WIRE_PROTOCOL_LATEST < (1 << WIRE_V2_VERSION_BITS), "Protocol version must fit into the header");
+
+// Header of a decoded frame
+struct WireHeader
+{
+    uint8_t version;  // Protocol version of the frame
+    uint8_t flags;    // WIRE_FLAG_* bits
+    uint8_t sequence; // Incremented with every transmitted frame, lets the receiver detect drops
+};
+
+// Timestamped lever positions of one sampling cycle
+struct LeverSample
+{
+    uint32_t timestampUs;                 // Time of the ADC frame in microseconds
+    int16_t leverPositions[LEVERS_COUNT]; // Lever positions calculated from the frame
+};
+
+size_t encodeControllerFrameV2(const controller_data_struct &data, const WireHeader &header, uint8_t *buffer);
+size_t encodeControllerFrameV3(const controller_data_struct &data, uint32_t timestampUs, const WireHeader &header,
+                               const LeverSample *history, uint8_t historyCount, uint8_t *buffer);
+bool decodeControllerFrame(const uint8_t *buffer, size_t length, controller_data_struct &data, WireHeader &header,
+                           LeverSample *history = nullptr, uint8_t *historyCount = nullptr);
+size_t encodeControllerFrame(const controller_data_struct &data, uint8_t flags, uint8_t *buffer, WireHeader &header,
+                             uint32_t timestampUs = 0, const LeverSample *history = nullptr, uint8_t historyCount = 0);
+void controllerFrameSent(const WireHeader &header);
+
+void setPeerProtocolVersion(uint8_t version);
+uint8_t getProtocolVersion(void);
+uint16_t crc16(const uint8_t *data, size_t length);
+
+#endif // WIRE_FORMAT_H
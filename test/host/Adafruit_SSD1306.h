@@ -0,0 +1,67 @@
+/**
+ * @file Adafruit_SSD1306.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef HOST_ADAFRUIT_SSD1306_H
+#define HOST_ADAFRUIT_SSD1306_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Stand-in for the Adafruit SSD1306 library on a development machine.
+ * Only the framebuffer and the calls used by DisplayPanel are provided, the pixel layout matches the
+ * SSD1306 display memory (pages of 8 pixel rows, one byte per column), so DisplayPanel builds for the
+ * host tests. Text and graphics rendering is not available.
+ */
+#define SSD1306_BLACK        0
+#define SSD1306_WHITE        1
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_DISPLAYOFF   0xAE
+
+class Adafruit_SSD1306
+{
+private:
+    uint8_t width;
+    uint8_t height;
+    uint8_t buffer[128 * 64 / 8] = {};
+
+public:
+    uint8_t lastCommand = 0; // Last command sent by ssd1306_command()
+
+    Adafruit_SSD1306(uint8_t w, uint8_t h) : width(w), height(h) {}
+
+    bool begin(uint8_t vccState, uint8_t address)
+    {
+        (void)vccState;
+        (void)address;
+        return width * height / 8 <= (int)sizeof(buffer);
+    }
+
+    void clearDisplay(void) { memset(buffer, 0, sizeof(buffer)); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+        if (x < 0 || x >= width || y < 0 || y >= height)
+            return;
+        if (color == SSD1306_WHITE)
+            buffer[x + (y / 8) * width] |= 1 << (y & 7);
+        else
+            buffer[x + (y / 8) * width] &= ~(1 << (y & 7));
+    }
+
+    uint8_t *getBuffer(void) { return buffer; }
+
+    void setTextColor(uint16_t color) { (void)color; }
+
+    void setTextSize(uint8_t size) { (void)size; }
+
+    void ssd1306_command(uint8_t command) { lastCommand = command; }
+};
+
+#endif // HOST_ADAFRUIT_SSD1306_H
@@ -0,0 +1,56 @@
+/**
+ * @file gpio.h
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#ifndef HOST_DRIVER_GPIO_H
+#define HOST_DRIVER_GPIO_H
+
+/*
+ * Stand-in for the ESP-IDF GPIO driver header on a development machine.
+ * Only the pin numbers of the ESP32 are provided, so include/constants.h builds for the host tests.
+ */
+typedef enum
+{
+    GPIO_NUM_NC = -1,
+    GPIO_NUM_0 = 0,
+    GPIO_NUM_1,
+    GPIO_NUM_2,
+    GPIO_NUM_3,
+    GPIO_NUM_4,
+    GPIO_NUM_5,
+    GPIO_NUM_6,
+    GPIO_NUM_7,
+    GPIO_NUM_8,
+    GPIO_NUM_9,
+    GPIO_NUM_10,
+    GPIO_NUM_11,
+    GPIO_NUM_12,
+    GPIO_NUM_13,
+    GPIO_NUM_14,
+    GPIO_NUM_15,
+    GPIO_NUM_16,
+    GPIO_NUM_17,
+    GPIO_NUM_18,
+    GPIO_NUM_19,
+    GPIO_NUM_21 = 21,
+    GPIO_NUM_22,
+    GPIO_NUM_23,
+    GPIO_NUM_25 = 25,
+    GPIO_NUM_26,
+    GPIO_NUM_27,
+    GPIO_NUM_32 = 32,
+    GPIO_NUM_33,
+    GPIO_NUM_34,
+    GPIO_NUM_35,
+    GPIO_NUM_36,
+    GPIO_NUM_37,
+    GPIO_NUM_38,
+    GPIO_NUM_39,
+} gpio_num_t;
+
+#endif // HOST_DRIVER_GPIO_H
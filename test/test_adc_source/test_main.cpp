@@ -0,0 +1,144 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ * The lever bank driven frame by frame by the synthetic ADC source instead of the ADC hardware.
+ */
+
+#include <stdlib.h>
+#include <unity.h>
+
+#include "lever_config.h"
+#include "lever_control.h"
+#include "synthetic_adc_source.h"
+
+// Center position of all levers at rest
+#define REST_LEVEL 512
+// Noise amplitude of the samples in ADC counts (typical for the lever potentiometers)
+#define REST_NOISE 6
+// Frames the levers need to settle after a jump (averaging window and the adaptive filters)
+#define SETTLE_FRAMES 40
+
+SyntheticAdcSource adcSource;
+LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW> levers(leverConfigs);
+
+/**
+ * @brief Starts the source for all levers and calibrates the levers at the rest position.
+ */
+void setUp(void)
+{
+    uint8_t pins[LEVERS_COUNT];
+    LeverCalibration calibration;
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        pins[i] = leverConfigs[i].pin;
+        calibration.center[i] = REST_LEVEL;
+        calibration.minAdcVal[i] = leverConfigs[i].minAdcVal;
+        calibration.maxAdcVal[i] = leverConfigs[i].maxAdcVal;
+    }
+
+    adcSource = SyntheticAdcSource();
+    TEST_ASSERT_TRUE(adcSource.begin(pins, LEVERS_COUNT));
+    adcSource.setNoise(REST_NOISE);
+    levers.calibrate(calibration);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Feeds the given number of frames to the levers.
+ *
+ * @return The number of frames with changed lever positions.
+ */
+static uint32_t runFrames(uint32_t count)
+{
+    AdcFrame frame;
+    uint32_t changes = 0;
+
+    adcSource.advance(count);
+    while (adcSource.readFrame(frame))
+        changes += levers.update(frame);
+
+    return changes;
+}
+
+void test_source_rejects_non_adc1_pins(void)
+{
+    const uint8_t pins[] = {BOOM_LEVER, BATTERY_VOLTAGE_PIN};
+    SyntheticAdcSource source;
+
+    TEST_ASSERT_FALSE(source.begin(pins, 2));
+}
+
+void test_source_produces_timestamped_frames_on_demand(void)
+{
+    AdcFrame frame;
+
+    TEST_ASSERT_FALSE(adcSource.readFrame(frame));
+
+    adcSource.advance(2);
+    TEST_ASSERT_TRUE(adcSource.readFrame(frame));
+    uint32_t firstUs = frame.timestampUs;
+    TEST_ASSERT_TRUE(adcSource.readFrame(frame));
+    TEST_ASSERT_EQUAL_UINT32(ADC_FRAME_INTERVAL_MS * 1000, frame.timestampUs - firstUs);
+    TEST_ASSERT_FALSE(adcSource.readFrame(frame));
+
+    for (const LeverConfig &config : leverConfigs)
+        TEST_ASSERT_INT_WITHIN(REST_NOISE, REST_LEVEL, frame.samples[adc1Channel(config.pin)]);
+}
+
+void test_levers_stay_neutral_at_rest(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, runFrames(10 * LEVER_SAMPLING_RATE_HZ));
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        TEST_ASSERT_EQUAL_INT16(0, levers.position(i));
+}
+
+void test_levers_reach_full_scale(void)
+{
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        const LeverConfig &config = leverConfigs[i];
+        int16_t expected = config.invert ? -LEVER_OUTPUT_MAX : LEVER_OUTPUT_MAX;
+
+        adcSource.setLevel(config.pin, SYNTHETIC_ADC_MAX);
+        runFrames(SETTLE_FRAMES);
+        TEST_ASSERT_EQUAL_INT16(expected, levers.position(i));
+
+        adcSource.setLevel(config.pin, 0);
+        runFrames(SETTLE_FRAMES);
+        TEST_ASSERT_EQUAL_INT16(-expected, levers.position(i));
+
+        adcSource.setLevel(config.pin, REST_LEVEL);
+        runFrames(SETTLE_FRAMES);
+        TEST_ASSERT_EQUAL_INT16(0, levers.position(i));
+    }
+}
+
+void test_levers_are_independent(void)
+{
+    adcSource.setLevel(leverConfigs[0].pin, SYNTHETIC_ADC_MAX);
+    runFrames(SETTLE_FRAMES);
+
+    TEST_ASSERT_EQUAL_INT16(LEVER_OUTPUT_MAX, abs(levers.position(0)));
+    for (uint8_t i = 1; i < LEVERS_COUNT; i++)
+        TEST_ASSERT_EQUAL_INT16(0, levers.position(i));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_source_rejects_non_adc1_pins);
+    RUN_TEST(test_source_produces_timestamped_frames_on_demand);
+    RUN_TEST(test_levers_stay_neutral_at_rest);
+    RUN_TEST(test_levers_reach_full_scale);
+    RUN_TEST(test_levers_are_independent);
+    return UNITY_END();
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * State of charge table of the battery compared with the former pow() sigmoid over the whole voltage
+ * range, the other curves and a microbenchmark of both conversions.
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <unity.h>
+
+#include "battery_curves.h"
+
+// Voltages checked below and above the range of the curve in millivolts
+#define CHECK_MARGIN_MV 300
+// Number of conversions measured by the benchmark
+#define BENCHMARK_CONVERSIONS 2000000
+
+/**
+ * @brief The former calculateBatteryLevel() with the pow() sigmoid.
+ */
+static uint8_t referenceLevel(uint16_t voltage)
+{
+    if (voltage <= MIN_BATT_MV)
+        return 0;
+    if (voltage >= MAX_BATT_MV)
+        return 100;
+
+    uint8_t result = 105 - (105 / (1 + pow(1.724 * (voltage - MIN_BATT_MV) / (MAX_BATT_MV - MIN_BATT_MV), 5.5)));
+    return result >= 100 ? 100 : result;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_table_points_match_sigmoid(void)
+{
+    // The table entries are evaluated by the compiler without pow(), they must match the former formula
+    for (uint32_t i = 0; i < BATTERY_CURVE_SIZE; i++)
+    {
+        uint16_t voltage = MIN_BATT_MV + i * BATTERY_CURVE_STEP_MV;
+        TEST_ASSERT_INT_WITHIN(1, referenceLevel(voltage), batteryCurveTable[i]);
+    }
+}
+
+void test_interpolation_follows_sigmoid(void)
+{
+    uint32_t maxError = 0, differences = 0;
+
+    for (uint16_t voltage = MIN_BATT_MV - CHECK_MARGIN_MV; voltage <= MAX_BATT_MV + CHECK_MARGIN_MV; voltage++)
+    {
+        uint32_t error = abs(batteryCurveLevel(voltage) - referenceLevel(voltage));
+        maxError = error > maxError ? error : maxError;
+        differences += error != 0;
+    }
+
+    char message[96];
+    snprintf(message, sizeof(message), "Table vs sigmoid: %u of %u voltages differ, max %u%%", differences,
+             MAX_BATT_MV - MIN_BATT_MV + 2 * CHECK_MARGIN_MV + 1, maxError);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, maxError);
+}
+
+void test_level_is_monotonic_and_bounded(void)
+{
+    uint8_t previous = 0;
+
+    for (uint16_t voltage = MIN_BATT_MV - CHECK_MARGIN_MV; voltage <= MAX_BATT_MV + CHECK_MARGIN_MV; voltage++)
+    {
+        uint8_t level = batteryCurveLevel(voltage);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(previous, level);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(100, level);
+        previous = level;
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(0, batteryCurveLevel(0));
+    TEST_ASSERT_EQUAL_UINT8(100, batteryCurveLevel(UINT16_MAX));
+}
+
+void test_compile_time_sqrt(void)
+{
+    for (double x = 0; x <= 2; x += 0.001)
+        TEST_ASSERT_FLOAT_WITHIN(1e-9, sqrt(x), batteryCurveSqrt(x));
+}
+
+void test_other_curves(void)
+{
+    constexpr BatteryCurveTable liion = makeBatteryCurveTable(BATTERY_CURVE_LIION);
+    constexpr BatteryCurveTable custom = makeBatteryCurveTable(BATTERY_CURVE_CUSTOM);
+    constexpr uint8_t liionPoints[] = BATTERY_CURVE_LIION_POINTS;
+
+    TEST_ASSERT_TRUE(isBatteryCurveMonotonic(liion));
+    TEST_ASSERT_TRUE(isBatteryCurveMonotonic(custom));
+    TEST_ASSERT_EQUAL_UINT8(0, custom[0]);
+    TEST_ASSERT_EQUAL_UINT8(100, custom[BATTERY_CURVE_SIZE - 1]);
+
+    // The defined points are kept exactly
+    const uint32_t pointStep = (BATTERY_CURVE_SIZE - 1) / (sizeof(liionPoints) - 1);
+    for (uint32_t i = 0; i < sizeof(liionPoints); i++)
+        TEST_ASSERT_EQUAL_UINT8(liionPoints[i], liion[i * pointStep]);
+}
+
+void test_benchmark_conversion(void)
+{
+    volatile uint32_t sink = 0;
+    const uint32_t range = MAX_BATT_MV - MIN_BATT_MV + 2 * CHECK_MARGIN_MV;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCHMARK_CONVERSIONS; i++)
+        sink = sink + referenceLevel(MIN_BATT_MV - CHECK_MARGIN_MV + i % range);
+    auto referenceEnd = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCHMARK_CONVERSIONS; i++)
+        sink = sink + batteryCurveLevel(MIN_BATT_MV - CHECK_MARGIN_MV + i % range);
+    auto tableEnd = std::chrono::steady_clock::now();
+
+    double referenceNs = std::chrono::duration<double, std::nano>(referenceEnd - start).count() / BENCHMARK_CONVERSIONS;
+    double tableNs = std::chrono::duration<double, std::nano>(tableEnd - referenceEnd).count() / BENCHMARK_CONVERSIONS;
+    char message[96];
+    snprintf(message, sizeof(message), "Conversion: pow() sigmoid %.1f ns, table %.1f ns", referenceNs, tableNs);
+    TEST_MESSAGE(message);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_table_points_match_sigmoid);
+    RUN_TEST(test_interpolation_follows_sigmoid);
+    RUN_TEST(test_level_is_monotonic_and_bounded);
+    RUN_TEST(test_compile_time_sqrt);
+    RUN_TEST(test_other_curves);
+    RUN_TEST(test_benchmark_conversion);
+    return UNITY_END();
+}
@@ -0,0 +1,271 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * DisplayPanel sending random frames of both displays over the mock bus with injected transfer
+ * failures: the emulated display memory must equal the framebuffer after every frame without a
+ * failure, and an unchanged frame must queue nothing.
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "display_bus_mock.h"
+#include "display_panel.h"
+
+// Number of random frames sent to both displays
+#define RANDOM_FRAMES 2000
+// Every FAILURE_EVERY-th frame (on average) loses up to FAILURE_TRANSFERS_MAX transfers
+#define FAILURE_EVERY         16
+#define FAILURE_TRANSFERS_MAX 3
+
+// I2C addresses of the left and right displays
+#define LEFT_ADDRESS  0x3C
+#define RIGHT_ADDRESS 0x3D
+
+static uint32_t randomState = 1;
+
+/**
+ * @brief Returns a pseudo-random number in the range of 0 to range - 1.
+ */
+static uint32_t randomNumber(uint32_t range)
+{
+    randomState = randomState * 1664525UL + 1013904223UL;
+    return (randomState >> 8) % range;
+}
+
+/**
+ * @brief Changes the framebuffer like the screens do: a few values, a filled area or a new screen.
+ */
+static void randomChange(Adafruit_SSD1306 &display)
+{
+    switch (randomNumber(5))
+    {
+        case 0: // Unchanged frame
+            break;
+        case 1: // A few pixels, e.g. a changed digit
+        {
+            uint8_t pixels = 1 + randomNumber(20);
+            for (uint8_t i = 0; i < pixels; i++)
+                display.drawPixel(randomNumber(SCREEN_WIDTH), randomNumber(SCREEN_HEIGHT), randomNumber(2));
+            break;
+        }
+        case 2: // A filled area, e.g. a bar graph
+        {
+            uint8_t x = randomNumber(SCREEN_WIDTH), y = randomNumber(SCREEN_HEIGHT);
+            uint8_t w = 1 + randomNumber(SCREEN_WIDTH - x), h = 1 + randomNumber(SCREEN_HEIGHT - y);
+            uint16_t color = randomNumber(2);
+            for (uint8_t dy = 0; dy < h; dy++)
+                for (uint8_t dx = 0; dx < w; dx++)
+                    display.drawPixel(x + dx, y + dy, color);
+            break;
+        }
+        case 3: // Cleared screen
+            display.clearDisplay();
+            break;
+        default: // New screen
+            for (uint16_t i = 0; i < SCREEN_BUFFER_SIZE; i++)
+                display.getBuffer()[i] = randomNumber(256);
+            break;
+    }
+}
+
+Adafruit_SSD1306 leftDisplay(SCREEN_WIDTH, SCREEN_HEIGHT);
+Adafruit_SSD1306 rightDisplay(SCREEN_WIDTH, SCREEN_HEIGHT);
+MockDisplayBus *bus;
+DisplayPanel *leftPanel;
+DisplayPanel *rightPanel;
+
+void setUp(void)
+{
+    randomState = 1;
+    leftDisplay.clearDisplay();
+    rightDisplay.clearDisplay();
+
+    bus = new MockDisplayBus(LEFT_ADDRESS, RIGHT_ADDRESS);
+    leftPanel = new DisplayPanel(leftDisplay, *bus, LEFT_ADDRESS);
+    rightPanel = new DisplayPanel(rightDisplay, *bus, RIGHT_ADDRESS);
+    TEST_ASSERT_TRUE(leftPanel->begin());
+    TEST_ASSERT_TRUE(rightPanel->begin());
+}
+
+void tearDown(void)
+{
+    delete leftPanel;
+    delete rightPanel;
+    delete bus;
+}
+
+/**
+ * @brief Flushes both displays page by page interleaved, like the display task does.
+ */
+static PanelFlushResult flushBoth(void)
+{
+    PanelFlushResult result = {0, 0};
+
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++)
+    {
+        PanelFlushResult left = leftPanel->flushPage(page);
+        PanelFlushResult right = rightPanel->flushPage(page);
+        result.pages += left.pages + right.pages;
+        result.bytes += left.bytes + right.bytes;
+    }
+
+    return result;
+}
+
+static void assertDisplaysMatch(void)
+{
+    TEST_ASSERT_EQUAL_MEMORY(leftDisplay.getBuffer(), bus->gddram(LEFT_ADDRESS), SCREEN_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(rightDisplay.getBuffer(), bus->gddram(RIGHT_ADDRESS), SCREEN_BUFFER_SIZE);
+}
+
+void test_first_flush_sends_whole_frames(void)
+{
+    PanelFlushResult result = flushBoth();
+
+    TEST_ASSERT_EQUAL_UINT8(2 * SCREEN_PAGES, result.pages);
+    TEST_ASSERT_EQUAL_UINT16(2 * SCREEN_PAGES * (SCREEN_WIDTH + DISPLAY_BUS_WINDOW_OVERHEAD), result.bytes);
+    assertDisplaysMatch();
+}
+
+void test_random_frames_with_failures(void)
+{
+    uint32_t failedFrames = 0, cleanFrames = 0, unchangedFrames = 0;
+    uint64_t sentBytes = 0;
+
+    flushBoth();
+
+    for (uint32_t frame = 0; frame < RANDOM_FRAMES; frame++)
+    {
+        randomChange(leftDisplay);
+        randomChange(rightDisplay);
+
+        bool failure = randomNumber(FAILURE_EVERY) == 0;
+        if (failure)
+            bus->failTransfers = 1 + randomNumber(FAILURE_TRANSFERS_MAX);
+
+        uint32_t errors = bus->errorCount();
+        uint32_t transfers = bus->transfers;
+        uint32_t bytes = bus->bytes;
+        PanelFlushResult result = flushBoth();
+
+        // The injected failures hit transfers only if the frame changed
+        if (bus->errorCount() != errors)
+        {
+            failedFrames++;
+            bus->failTransfers = 0;
+            continue;
+        }
+        bus->failTransfers = 0;
+
+        // Without a failure the display memory is repaired and matches the frame, the counts match the bus
+        assertDisplaysMatch();
+        TEST_ASSERT_EQUAL_UINT32(result.bytes, bus->bytes - bytes);
+        TEST_ASSERT_EQUAL_UINT32(result.pages, bus->transfers - transfers);
+        sentBytes += result.bytes;
+        cleanFrames++;
+        unchangedFrames += result.pages == 0;
+    }
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u frames: %u clean (%u unchanged), %u with failures | %.0f bytes per frame",
+             RANDOM_FRAMES, cleanFrames, unchangedFrames, failedFrames, (double)sentBytes / cleanFrames);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, failedFrames);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, unchangedFrames);
+}
+
+void test_unchanged_frame_queues_nothing(void)
+{
+    randomChange(leftDisplay);
+    flushBoth();
+    uint32_t transfers = bus->transfers;
+
+    PanelFlushResult result = flushBoth();
+
+    TEST_ASSERT_EQUAL_UINT8(0, result.pages);
+    TEST_ASSERT_EQUAL_UINT16(0, result.bytes);
+    TEST_ASSERT_EQUAL_UINT32(transfers, bus->transfers);
+}
+
+void test_only_changed_columns_are_sent(void)
+{
+    flushBoth();
+
+    leftDisplay.drawPixel(10, 3, SSD1306_WHITE);
+    leftDisplay.drawPixel(20, 5, SSD1306_WHITE);
+    PanelFlushResult result = flushBoth();
+
+    TEST_ASSERT_EQUAL_UINT8(1, result.pages);
+    TEST_ASSERT_EQUAL_UINT16(20 - 10 + 1 + DISPLAY_BUS_WINDOW_OVERHEAD, result.bytes);
+    assertDisplaysMatch();
+}
+
+void test_failure_invalidates_display_memory(void)
+{
+    flushBoth();
+
+    // The first page is queued but lost, the following pages of the flush find out and send the whole pages
+    leftDisplay.drawPixel(0, 0, SSD1306_WHITE);
+    leftDisplay.drawPixel(0, 8, SSD1306_WHITE);
+    bus->failTransfers = 1;
+    PanelFlushResult result = flushBoth();
+    TEST_ASSERT_EQUAL_UINT8(0, bus->gddram(LEFT_ADDRESS)[0]);
+    TEST_ASSERT_EQUAL_UINT8(2 * SCREEN_PAGES, result.pages);
+    TEST_ASSERT_EQUAL_UINT32(1, bus->errorCount());
+
+    // Only the lost page is left to repair
+    result = flushBoth();
+    TEST_ASSERT_EQUAL_UINT8(1, result.pages);
+    TEST_ASSERT_EQUAL_UINT16(SCREEN_WIDTH + DISPLAY_BUS_WINDOW_OVERHEAD, result.bytes);
+    assertDisplaysMatch();
+}
+
+void test_background_restores_static_parts(void)
+{
+    for (uint8_t x = 0; x < SCREEN_WIDTH; x++)
+        leftDisplay.drawPixel(x, 0, SSD1306_WHITE);
+    leftPanel->saveBackground();
+    flushBoth();
+
+    // Values drawn over the background are removed by the next frame
+    leftDisplay.drawPixel(50, 40, SSD1306_WHITE);
+    flushBoth();
+    leftPanel->restoreBackground();
+    PanelFlushResult result = flushBoth();
+
+    TEST_ASSERT_EQUAL_UINT8(1, result.pages);
+    assertDisplaysMatch();
+}
+
+void test_power_off_clears_display(void)
+{
+    randomChange(leftDisplay);
+    flushBoth();
+
+    TEST_ASSERT_TRUE(leftPanel->powerOff());
+
+    uint8_t cleared[SCREEN_BUFFER_SIZE] = {};
+    TEST_ASSERT_EQUAL_MEMORY(cleared, bus->gddram(LEFT_ADDRESS), SCREEN_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_UINT8(SSD1306_DISPLAYOFF, leftDisplay.lastCommand);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_flush_sends_whole_frames);
+    RUN_TEST(test_random_frames_with_failures);
+    RUN_TEST(test_unchanged_frame_queues_nothing);
+    RUN_TEST(test_only_changed_columns_are_sent);
+    RUN_TEST(test_failure_invalidates_display_memory);
+    RUN_TEST(test_background_restores_static_parts);
+    RUN_TEST(test_power_off_clears_display);
+    return UNITY_END();
+}
@@ -0,0 +1,269 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ * LeverBank compared with the former per-object Lever::update() loop: RAM footprint, results at rest
+ * positions and a microbenchmark of one control tick.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <unity.h>
+
+#include "lever_config.h"
+#include "lever_control.h"
+#include "synthetic_adc_source.h"
+
+// Number of frames measured by one round of the benchmark
+#define BENCHMARK_FRAMES 50000
+// Number of interleaved rounds, the fastest round of each implementation is compared
+#define BENCHMARK_ROUNDS 9
+// Number of different frames fed to the benchmark in a loop
+#define BENCHMARK_PATTERN 4096
+// RAM budget of the lever bank, the per-lever response tables of 2 KB each must not come back
+#define LEVER_BANK_MAX_BYTES 1024
+
+/**
+ * @brief The former Lever class reading the samples from the frames instead of analogRead().
+ */
+class ReferenceLever
+{
+private:
+    uint8_t pin;
+    uint16_t minAdcVal;
+    uint16_t maxAdcVal;
+    uint16_t zeroPos = 0;
+    uint16_t deadZone;
+    bool invert;
+    bool exponentialSmoothing;
+    int16_t pos = 0;
+    int16_t lastPos = -999;
+    uint16_t rawValue = 0;
+    int16_t minOutput = -1023;
+    int16_t maxOutput = 1023;
+    uint16_t updateInterval = 10; // Not used, kept for the size of the former object
+    uint32_t lastUpdateTime = 0;  // Not used, kept for the size of the former object
+
+    uint8_t numReadings = 10;
+    uint16_t readings[10];
+    uint8_t readIndex = 0;
+    uint32_t total = 0;
+    int16_t calcRes = 0;
+
+    static long map(long x, long inMin, long inMax, long outMin, long outMax)
+    {
+        return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+    }
+
+    int16_t readAndFilter(uint16_t sample)
+    {
+        total = total - readings[readIndex];
+        rawValue = sample;
+        readings[readIndex] = rawValue;
+        total = total + readings[readIndex];
+        readIndex = (readIndex + 1) % numReadings;
+        calcRes = total / numReadings;
+
+        if (abs(calcRes - zeroPos) < deadZone)
+        {
+            calcRes = 0;
+        }
+        else
+        {
+            if (calcRes < zeroPos)
+                calcRes = map(calcRes, minAdcVal, zeroPos - deadZone, minOutput, 0);
+            else
+                calcRes = map(calcRes, zeroPos + deadZone, maxAdcVal, 0, maxOutput);
+
+            calcRes = calcRes < minOutput ? minOutput : calcRes > maxOutput ? maxOutput : calcRes;
+
+            if (exponentialSmoothing)
+                calcRes = pow(calcRes, 3) / pow(maxOutput, 2);
+
+            if (invert)
+                calcRes = -calcRes;
+        }
+
+        return calcRes;
+    }
+
+public:
+    explicit ReferenceLever(const LeverConfig &config)
+        : pin(config.pin), minAdcVal(config.minAdcVal), maxAdcVal(config.maxAdcVal), deadZone(config.deadZone),
+          invert(config.invert), exponentialSmoothing(config.curve == LEVER_CURVE_CUBIC)
+    {
+    }
+
+    void calibrate(uint16_t center)
+    {
+        zeroPos = center;
+        total = 0;
+        for (uint8_t i = 0; i < numReadings; i++)
+        {
+            readings[i] = zeroPos;
+            total += zeroPos;
+        }
+    }
+
+    bool update(const AdcFrame &frame)
+    {
+        pos = readAndFilter(frame.samples[adc1Channel(pin)]);
+        bool hasChanged = lastPos != pos;
+        lastPos = pos;
+        return hasChanged;
+    }
+
+    int16_t position() const
+    {
+        return pos;
+    }
+};
+
+// Configuration matching the former levers: moving average, no quantization and no hysteresis
+LeverConfig referenceConfigs[LEVERS_COUNT];
+
+SyntheticAdcSource adcSource;
+LeverCalibration calibration;
+
+void setUp(void)
+{
+    uint8_t pins[LEVERS_COUNT];
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        referenceConfigs[i] = leverConfigs[i];
+        referenceConfigs[i].filter = LEVER_FILTER_AVERAGE;
+        referenceConfigs[i].quantum = 1;
+        referenceConfigs[i].hysteresis = 0;
+
+        pins[i] = leverConfigs[i].pin;
+        calibration.center[i] = 500 + 5 * i;
+        calibration.minAdcVal[i] = leverConfigs[i].minAdcVal;
+        calibration.maxAdcVal[i] = leverConfigs[i].maxAdcVal;
+    }
+
+    adcSource = SyntheticAdcSource();
+    TEST_ASSERT_TRUE(adcSource.begin(pins, LEVERS_COUNT));
+}
+
+void tearDown(void)
+{
+}
+
+void test_ram_footprint(void)
+{
+    char message[96];
+    snprintf(message, sizeof(message), "RAM: LeverBank %u bytes, %u Lever objects %u bytes",
+             (unsigned)sizeof(LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW>), LEVERS_COUNT,
+             (unsigned)(LEVERS_COUNT * sizeof(ReferenceLever)));
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_LESS_OR_EQUAL(LEVER_BANK_MAX_BYTES, sizeof(LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW>));
+}
+
+void test_rest_positions_match_reference(void)
+{
+    LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW> bank(referenceConfigs);
+    ReferenceLever *references[LEVERS_COUNT];
+    AdcFrame frame;
+
+    bank.calibrate(calibration);
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        references[i] = new ReferenceLever(referenceConfigs[i]);
+        references[i]->calibrate(calibration.center[i]);
+    }
+
+    // Both averages settle on the same value, the positions have to be the same then
+    for (uint16_t level = 0; level <= SYNTHETIC_ADC_MAX; level += 7)
+    {
+        for (const LeverConfig &config : referenceConfigs)
+            adcSource.setLevel(config.pin, level);
+
+        adcSource.advance(2 * 10);
+        while (adcSource.readFrame(frame))
+        {
+            bank.update(frame);
+            for (ReferenceLever *reference : references)
+                reference->update(frame);
+        }
+
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+            TEST_ASSERT_EQUAL_INT16(references[i]->position(), bank.position(i));
+    }
+
+    for (ReferenceLever *reference : references)
+        delete reference;
+}
+
+void test_benchmark_update(void)
+{
+    static AdcFrame frames[BENCHMARK_PATTERN];
+    LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW> bank(referenceConfigs);
+    LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW> configuredBank(leverConfigs);
+    ReferenceLever *references[LEVERS_COUNT];
+    volatile uint32_t sink = 0;
+
+    // Levers swept slowly over the full range with the typical noise
+    adcSource.setNoise(6);
+    for (uint32_t i = 0; i < BENCHMARK_PATTERN; i++)
+    {
+        for (uint8_t lever = 0; lever < LEVERS_COUNT; lever++)
+            adcSource.setLevel(leverConfigs[lever].pin, (i * (lever + 1)) % (SYNTHETIC_ADC_MAX + 1));
+        adcSource.advance(1);
+        adcSource.readFrame(frames[i]);
+    }
+
+    bank.calibrate(calibration);
+    configuredBank.calibrate(calibration);
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        references[i] = new ReferenceLever(referenceConfigs[i]);
+        references[i]->calibrate(calibration.center[i]);
+    }
+
+    // Time per frame of the given tick, the rounds are interleaved so a slow period affects all of them
+    auto measure = [](auto tick) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCHMARK_FRAMES; i++)
+            tick(frames[i % BENCHMARK_PATTERN]);
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / BENCHMARK_FRAMES;
+    };
+    double referenceNs = INFINITY;
+    double bankNs = INFINITY;
+    double configuredNs = INFINITY;
+    for (uint32_t round = 0; round < BENCHMARK_ROUNDS; round++)
+    {
+        referenceNs = fmin(referenceNs, measure([&](const AdcFrame &frame) {
+            for (ReferenceLever *reference : references)
+                sink = sink + reference->update(frame);
+        }));
+        bankNs = fmin(bankNs, measure([&](const AdcFrame &frame) { sink = sink + bank.update(frame); }));
+        configuredNs = fmin(configuredNs, measure([&](const AdcFrame &frame) { sink = sink + configuredBank.update(frame); }));
+    }
+
+    for (ReferenceLever *reference : references)
+        delete reference;
+
+    char message[128];
+    snprintf(message, sizeof(message),
+             "Tick of %u levers: Lever objects %.1f ns, LeverBank %.1f ns (configured filters %.1f ns)", LEVERS_COUNT,
+             referenceNs, bankNs, configuredNs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(bankNs <= referenceNs, "The LeverBank must not be slower than the Lever objects");
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ram_footprint);
+    RUN_TEST(test_rest_positions_match_reference);
+    RUN_TEST(test_benchmark_update);
+    return UNITY_END();
+}
@@ -0,0 +1,208 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ * Equivalence of the lever response with the calibration folded into its mapping with the former float
+ * pipeline of Lever::readAndFilter() and a benchmark of both per control tick.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <unity.h>
+
+#include "lever_config.h"
+#include "lever_control.h"
+
+// Number of control ticks measured by the benchmark
+#define BENCHMARK_TICKS 200000
+
+// Output range of the former Lever class
+#define REFERENCE_OUTPUT_MAX 1023
+
+/**
+ * @brief Arduino map() as used by the former Lever class.
+ */
+static long arduinoMap(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+/**
+ * @brief Former Lever::readAndFilter() after the moving average: map(), constrain() and pow().
+ */
+static int16_t referencePosition(const LeverConfig &config, uint16_t zeroPos, uint16_t minAdcVal, uint16_t maxAdcVal,
+                                 int16_t calcRes)
+{
+    if (abs(calcRes - zeroPos) < config.deadZone)
+        return 0;
+
+    if (calcRes < zeroPos)
+        calcRes = arduinoMap(calcRes, minAdcVal, zeroPos - config.deadZone, -REFERENCE_OUTPUT_MAX, 0);
+    else
+        calcRes = arduinoMap(calcRes, zeroPos + config.deadZone, maxAdcVal, 0, REFERENCE_OUTPUT_MAX);
+
+    if (calcRes < -REFERENCE_OUTPUT_MAX)
+        calcRes = -REFERENCE_OUTPUT_MAX;
+    if (calcRes > REFERENCE_OUTPUT_MAX)
+        calcRes = REFERENCE_OUTPUT_MAX;
+
+    if (config.curve == LEVER_CURVE_CUBIC)
+        calcRes = pow(calcRes, 3) / pow(REFERENCE_OUTPUT_MAX, 2);
+
+    if (config.invert)
+        calcRes = -calcRes;
+
+    return calcRes;
+}
+
+/**
+ * @brief Returns the configuration of the lever with the given curve and without quantization.
+ */
+static LeverConfig referenceConfig(const LeverConfig &config, LeverCurve curve)
+{
+    LeverConfig result = config;
+    result.curve = curve;
+    result.quantum = 1;
+    return result;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_curve_tables_match_pow(void)
+{
+    const LeverCurveTable &cubic = leverCurveTables[LEVER_CURVE_CUBIC];
+
+    for (int32_t x = 0; x < LEVER_CURVE_SIZE; x++)
+    {
+        TEST_ASSERT_EQUAL_INT((int32_t)(pow(x, 3) / pow(LEVER_CURVE_MAX, 2)), cubic[x]);
+        TEST_ASSERT_EQUAL_INT(x, leverCurveTables[LEVER_CURVE_LINEAR][x]);
+    }
+}
+
+void test_curve_tables_are_monotonic(void)
+{
+    for (const LeverCurveTable &table : leverCurveTables)
+    {
+        TEST_ASSERT_EQUAL_INT(0, table[0]);
+        for (int32_t x = 1; x < LEVER_CURVE_SIZE; x++)
+            TEST_ASSERT_LESS_OR_EQUAL(table[x], table[x - 1]);
+    }
+}
+
+void test_response_matches_float_pipeline(void)
+{
+    const uint16_t centers[] = {300, 480, 512, 530, 700};
+    const LeverCurve curves[] = {LEVER_CURVE_LINEAR, LEVER_CURVE_CUBIC};
+
+    for (const LeverConfig &lever : leverConfigs)
+    {
+        for (LeverCurve curve : curves)
+        {
+            LeverConfig config = referenceConfig(lever, curve);
+
+            for (uint16_t center : centers)
+            {
+                LeverMapping mapping = makeLeverMapping(config, center, config.minAdcVal, config.maxAdcVal);
+
+                for (int32_t adcVal = 0; adcVal < LEVER_CURVE_SIZE; adcVal++)
+                {
+                    int16_t expected = referencePosition(config, center, config.minAdcVal, config.maxAdcVal, adcVal);
+                    int16_t actual = leverResponse(mapping, adcVal);
+                    if (expected != actual)
+                    {
+                        char message[96];
+                        snprintf(message, sizeof(message), "pin %u, curve %u, center %u, ADC %ld", config.pin, curve,
+                                 center, (long)adcVal);
+                        TEST_ASSERT_EQUAL_INT16_MESSAGE(expected, actual, message);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void test_quantization_keeps_full_scale(void)
+{
+    LeverConfig config = referenceConfig(leverConfigs[0], LEVER_CURVE_LINEAR);
+    config.quantum = 8;
+    LeverMapping mapping = makeLeverMapping(config, 512, config.minAdcVal, config.maxAdcVal);
+
+    for (int32_t adcVal = 0; adcVal < LEVER_CURVE_SIZE; adcVal++)
+    {
+        int16_t magnitude = abs(leverResponse(mapping, adcVal));
+        int16_t unquantized = abs(referencePosition(config, 512, config.minAdcVal, config.maxAdcVal, adcVal));
+        if (magnitude != LEVER_OUTPUT_MAX)
+            TEST_ASSERT_EQUAL_INT(0, magnitude % config.quantum);
+        TEST_ASSERT_LESS_OR_EQUAL(unquantized, magnitude);
+        TEST_ASSERT_LESS_THAN(config.quantum, unquantized - magnitude);
+    }
+    TEST_ASSERT_EQUAL_INT(LEVER_OUTPUT_MAX, abs(leverResponse(mapping, 0)));
+    TEST_ASSERT_EQUAL_INT(LEVER_OUTPUT_MAX, abs(leverResponse(mapping, LEVER_CURVE_MAX)));
+}
+
+void test_benchmark_control_tick(void)
+{
+    LeverConfig configs[LEVERS_COUNT];
+    LeverMapping mappings[LEVERS_COUNT];
+    uint16_t averages[256][LEVERS_COUNT];
+    volatile int32_t sink = 0;
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        configs[i] = referenceConfig(leverConfigs[i], LEVER_CURVE_CUBIC);
+        mappings[i] = makeLeverMapping(configs[i], 512, configs[i].minAdcVal, configs[i].maxAdcVal);
+    }
+    srand(1);
+    for (auto &row : averages)
+    {
+        for (uint16_t &average : row)
+            average = rand() % LEVER_CURVE_SIZE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < BENCHMARK_TICKS; tick++)
+    {
+        const uint16_t *row = averages[tick & 0xFF];
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+            sink = sink + referencePosition(configs[i], 512, configs[i].minAdcVal, configs[i].maxAdcVal, row[i]);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < BENCHMARK_TICKS; tick++)
+    {
+        const uint16_t *row = averages[tick & 0xFF];
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+            sink = sink + leverResponse(mappings[i], row[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double floatNs = std::chrono::duration<double, std::nano>(middle - start).count() / BENCHMARK_TICKS;
+    double integerNs = std::chrono::duration<double, std::nano>(end - middle).count() / BENCHMARK_TICKS;
+    char message[96];
+    snprintf(message, sizeof(message), "Control tick of %u levers: float %.1f ns, folded mapping %.1f ns", LEVERS_COUNT,
+             floatNs, integerNs);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_LESS_THAN_FLOAT(floatNs, integerNs);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_curve_tables_match_pow);
+    RUN_TEST(test_curve_tables_are_monotonic);
+    RUN_TEST(test_response_matches_float_pipeline);
+    RUN_TEST(test_quantization_keeps_full_scale);
+    RUN_TEST(test_benchmark_control_tick);
+    return UNITY_END();
+}
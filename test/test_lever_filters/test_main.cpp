@@ -0,0 +1,212 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ * Step-response latency and rest-noise amplitude of the lever filters at the sampling rate of the levers.
+ */
+
+#include <stdio.h>
+#include <unity.h>
+
+#include "lever_config.h"
+#include "lever_filters.h"
+#include "synthetic_adc_source.h"
+
+// Lever position at rest and the size of the step in ADC counts
+#define STEP_FROM 512
+#define STEP_SIZE 300
+// Share of the step the filter output has to reach to count as settled in percent
+#define STEP_SETTLED_PERCENT 90
+// Noise amplitude of the samples in ADC counts (typical for the lever potentiometers)
+#define SAMPLE_NOISE 6
+// Frames measured at rest and the frames before the measurement to settle the filters
+#define REST_FRAMES   4000
+#define SETTLE_FRAMES 200
+// Window of the moving average of the former Lever class (measured at the current frame rate, the former
+// Lever class was updated every 10 ms, so its real latency was twice as long)
+#define FORMER_AVERAGE_WINDOW 10
+
+enum FilterUnderTest
+{
+    FILTER_FORMER_AVERAGE, // Moving average over FORMER_AVERAGE_WINDOW frames
+    FILTER_AVERAGE,        // Moving average over LEVER_FILTER_WINDOW frames
+    FILTER_ONE_EURO,
+    FILTER_KALMAN,
+    FILTERS_UNDER_TEST_COUNT
+};
+
+const char *const filterNames[FILTERS_UNDER_TEST_COUNT] = {"former average", "average", "One-Euro", "Kalman"};
+
+// Measured characteristics of a filter
+struct FilterResult
+{
+    float latencyMs; // Time to reach STEP_SETTLED_PERCENT of the step
+    float restNoise; // Peak-to-peak amplitude of the output at rest in ADC counts
+};
+
+/**
+ * @brief Filter of one lever fed with the frames of the synthetic source.
+ */
+class FilterRunner
+{
+private:
+    FilterUnderTest filter;
+    LeverFilterState state = {};
+    uint16_t readings[FORMER_AVERAGE_WINDOW] = {};
+    uint8_t readIndex = 0;
+    uint32_t total = 0;
+
+public:
+    FilterRunner(FilterUnderTest _filter, uint16_t value) : filter(_filter)
+    {
+        for (uint16_t &reading : readings)
+            reading = value;
+        total = (uint32_t)value * window();
+        resetLeverFilter(state, value, filter == FILTER_KALMAN ? leverKalmanParams.measurementNoise : 0.0f);
+    }
+
+    uint8_t window() const
+    {
+        return filter == FILTER_FORMER_AVERAGE ? FORMER_AVERAGE_WINDOW : LEVER_FILTER_WINDOW;
+    }
+
+    float update(uint16_t sample)
+    {
+        const float dt = ADC_FRAME_INTERVAL_MS / 1000.0f;
+
+        switch (filter)
+        {
+            case FILTER_ONE_EURO:
+                return oneEuroFilter(state, sample, dt, leverOneEuroParams);
+            case FILTER_KALMAN:
+                return kalmanFilter(state, sample, leverKalmanParams);
+            default:
+                total += sample - readings[readIndex];
+                readings[readIndex] = sample;
+                readIndex = (readIndex + 1) % window();
+                return (float)total / window();
+        }
+    }
+};
+
+SyntheticAdcSource adcSource;
+
+/**
+ * @brief Returns the sample of the boom lever from the next frame of the source.
+ */
+static uint16_t nextSample(void)
+{
+    AdcFrame frame;
+    adcSource.advance(1);
+    adcSource.readFrame(frame);
+    return frame.samples[adc1Channel(leverConfigs[0].pin)];
+}
+
+/**
+ * @brief Measures the step response and the rest noise of the filter.
+ */
+static FilterResult measureFilter(FilterUnderTest filter)
+{
+    FilterResult result = {};
+    FilterRunner runner(filter, STEP_FROM);
+
+    adcSource.setNoise(SAMPLE_NOISE);
+    adcSource.setLevel(leverConfigs[0].pin, STEP_FROM);
+
+    // Rest noise
+    float minimum = STEP_FROM, maximum = STEP_FROM;
+    for (uint32_t i = 0; i < SETTLE_FRAMES + REST_FRAMES; i++)
+    {
+        float value = runner.update(nextSample());
+        if (i < SETTLE_FRAMES)
+            continue;
+        minimum = value < minimum ? value : minimum;
+        maximum = value > maximum ? value : maximum;
+    }
+    result.restNoise = maximum - minimum;
+
+    // Step response
+    const float settled = STEP_FROM + STEP_SIZE * STEP_SETTLED_PERCENT / 100.0f;
+    adcSource.setLevel(leverConfigs[0].pin, STEP_FROM + STEP_SIZE);
+    for (uint32_t frames = 1; frames <= SETTLE_FRAMES; frames++)
+    {
+        if (runner.update(nextSample()) >= settled)
+        {
+            result.latencyMs = frames * ADC_FRAME_INTERVAL_MS;
+            break;
+        }
+    }
+
+    return result;
+}
+
+void setUp(void)
+{
+    const uint8_t pin = leverConfigs[0].pin;
+    adcSource = SyntheticAdcSource();
+    adcSource.begin(&pin, 1);
+}
+
+void tearDown(void)
+{
+}
+
+void test_report_filters(void)
+{
+    for (uint8_t filter = 0; filter < FILTERS_UNDER_TEST_COUNT; filter++)
+    {
+        FilterResult result = measureFilter((FilterUnderTest)filter);
+
+        char message[96];
+        snprintf(message, sizeof(message), "%-14s: %2d%% step latency %5.1f ms, rest noise %4.1f counts p-p",
+                 filterNames[filter], STEP_SETTLED_PERCENT, result.latencyMs, result.restNoise);
+        TEST_MESSAGE(message);
+
+        // Every filter has to settle within the measured frames
+        TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, result.latencyMs);
+    }
+}
+
+void test_adaptive_filters_track_faster(void)
+{
+    float formerLatencyMs = measureFilter(FILTER_FORMER_AVERAGE).latencyMs;
+
+    TEST_ASSERT_LESS_THAN_FLOAT(formerLatencyMs, measureFilter(FILTER_ONE_EURO).latencyMs);
+    TEST_ASSERT_LESS_THAN_FLOAT(formerLatencyMs, measureFilter(FILTER_KALMAN).latencyMs);
+}
+
+void test_adaptive_filters_not_noisier_at_rest(void)
+{
+    float formerRestNoise = measureFilter(FILTER_FORMER_AVERAGE).restNoise;
+
+    TEST_ASSERT_LESS_THAN_FLOAT(formerRestNoise, measureFilter(FILTER_ONE_EURO).restNoise);
+    TEST_ASSERT_LESS_THAN_FLOAT(formerRestNoise, measureFilter(FILTER_KALMAN).restNoise);
+}
+
+void test_filters_stay_within_dead_zone_at_rest(void)
+{
+    // The smallest dead zone of the levers must hide the remaining noise at rest
+    uint16_t deadZone = UINT16_MAX;
+    for (const LeverConfig &config : leverConfigs)
+        deadZone = config.deadZone < deadZone ? config.deadZone : deadZone;
+
+    for (uint8_t filter = 0; filter < FILTERS_UNDER_TEST_COUNT; filter++)
+    {
+        float restNoise = measureFilter((FilterUnderTest)filter).restNoise;
+        TEST_ASSERT_LESS_THAN_FLOAT(2 * SAMPLE_NOISE, restNoise);
+        TEST_ASSERT_LESS_THAN_FLOAT(deadZone, restNoise);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_report_filters);
+    RUN_TEST(test_adaptive_filters_track_faster);
+    RUN_TEST(test_adaptive_filters_not_noisier_at_rest);
+    RUN_TEST(test_filters_stay_within_dead_zone_at_rest);
+    return UNITY_END();
+}
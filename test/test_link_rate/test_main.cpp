@@ -0,0 +1,224 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * Send rate controller: reaction to single losses, loss bursts and keepalive failures, and the time to
+ * recover the fastest rate compared with the former controller doubling on every failure.
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include <stdio.h>
+#include <unity.h>
+
+#include "link_rate_controller.h"
+
+// MAC latency of a clean link in microseconds
+#define CLEAN_LATENCY_US 2000
+// Interval the controllers start with in milliseconds
+#define START_INTERVAL 25
+
+/**
+ * @brief The former controller: doubled on every failure, shortened by 1 ms per clean frame.
+ */
+class ReferenceController
+{
+public:
+    uint32_t intervalMs;
+    uint32_t successPermille = 1000;
+    uint32_t avgLatencyUs = 0;
+
+    explicit ReferenceController(uint32_t _intervalMs) : intervalMs(_intervalMs)
+    {
+    }
+
+    void report(bool delivered, uint32_t latencyUs, bool userActive)
+    {
+        int32_t success = delivered ? 1000 : 0;
+        successPermille += (success - (int32_t)successPermille) / LINK_RATE_EWMA_DIVISOR;
+        avgLatencyUs += ((int32_t)latencyUs - (int32_t)avgLatencyUs) / LINK_RATE_EWMA_DIVISOR;
+
+        if (!delivered)
+        {
+            intervalMs = intervalMs * 2 < LINK_RATE_SLOWEST_INTERVAL ? intervalMs * 2 : LINK_RATE_SLOWEST_INTERVAL;
+        }
+        else
+        {
+            bool clean = successPermille >= LINK_RATE_CLEAN_SUCCESS_PERMILLE &&
+                         avgLatencyUs * 100 < intervalMs * 1000 * LINK_RATE_CLEAN_LATENCY_PERCENT;
+            if (clean && userActive && intervalMs > LINK_RATE_FASTEST_INTERVAL)
+                intervalMs--;
+        }
+    }
+
+    uint32_t interval() const
+    {
+        return intervalMs;
+    }
+};
+
+/**
+ * @brief Adapter giving both controllers the same interface.
+ */
+class Controller : public LinkRateController
+{
+public:
+    using LinkRateController::LinkRateController;
+
+    uint32_t interval() const
+    {
+        return getState().intervalMs;
+    }
+};
+
+/**
+ * @brief Reports clean frames with user input until the fastest interval is reached.
+ *
+ * @return Time spent sending the frames at the current intervals in milliseconds, 0 if not recovered.
+ */
+template <typename T>
+static uint32_t recoveryTimeMs(T &controller)
+{
+    uint32_t elapsedMs = 0;
+    for (uint32_t frame = 0; frame < 10000 && controller.interval() > LINK_RATE_FASTEST_INTERVAL; frame++)
+    {
+        elapsedMs += controller.interval();
+        controller.report(true, CLEAN_LATENCY_US, true);
+    }
+    return controller.interval() == LINK_RATE_FASTEST_INTERVAL ? elapsedMs : 0;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_single_loss_keeps_the_interval(void)
+{
+    Controller controller(START_INTERVAL);
+    ReferenceController reference(START_INTERVAL);
+
+    controller.report(false, CLEAN_LATENCY_US, true);
+    reference.report(false, CLEAN_LATENCY_US, true);
+
+    TEST_ASSERT_EQUAL_UINT32(START_INTERVAL, controller.interval());
+    TEST_ASSERT_EQUAL_UINT32(2 * START_INTERVAL, reference.interval());
+    TEST_ASSERT_EQUAL_UINT32(0, controller.getState().backOffs);
+    TEST_ASSERT_EQUAL_UINT32(1, controller.getState().failed);
+}
+
+void test_lossy_window_backs_off(void)
+{
+    Controller controller(START_INTERVAL);
+
+    // Every third frame lost
+    for (uint8_t i = 0; i < LINK_RATE_WINDOW_FRAMES; i++)
+        controller.report(i % 3 != 2, CLEAN_LATENCY_US, true);
+
+    TEST_ASSERT_EQUAL_UINT32(2 * START_INTERVAL, controller.interval());
+    TEST_ASSERT_EQUAL_UINT32(1, controller.getState().backOffs);
+}
+
+void test_failure_burst_backs_off_at_once(void)
+{
+    Controller controller(START_INTERVAL);
+
+    for (uint8_t i = 0; i < LINK_RATE_BURST_FAILURES - 1; i++)
+        controller.report(false, CLEAN_LATENCY_US, true);
+    TEST_ASSERT_EQUAL_UINT32(START_INTERVAL, controller.interval());
+
+    controller.report(false, CLEAN_LATENCY_US, true);
+    TEST_ASSERT_EQUAL_UINT32(2 * START_INTERVAL, controller.interval());
+
+    // A dead link ends at the slowest interval
+    for (uint8_t i = 0; i < 10 * LINK_RATE_BURST_FAILURES; i++)
+        controller.report(false, CLEAN_LATENCY_US, true);
+    TEST_ASSERT_EQUAL_UINT32(LINK_RATE_SLOWEST_INTERVAL, controller.interval());
+}
+
+void test_keepalive_failures_are_ignored(void)
+{
+    Controller controller(START_INTERVAL);
+
+    for (uint8_t i = 0; i < 5 * LINK_RATE_WINDOW_FRAMES; i++)
+        controller.report(false, CLEAN_LATENCY_US, false);
+
+    TEST_ASSERT_EQUAL_UINT32(START_INTERVAL, controller.interval());
+    TEST_ASSERT_EQUAL_UINT32(5 * LINK_RATE_WINDOW_FRAMES, controller.getState().failed);
+}
+
+void test_keepalives_do_not_speed_up(void)
+{
+    Controller controller(START_INTERVAL);
+
+    for (uint8_t i = 0; i < 5 * LINK_RATE_WINDOW_FRAMES; i++)
+        controller.report(true, CLEAN_LATENCY_US, false);
+
+    TEST_ASSERT_EQUAL_UINT32(START_INTERVAL, controller.interval());
+}
+
+void test_high_latency_blocks_speed_up(void)
+{
+    Controller controller(START_INTERVAL);
+
+    for (uint8_t i = 0; i < 5 * LINK_RATE_WINDOW_FRAMES; i++)
+        controller.report(true, START_INTERVAL * 1000, true);
+
+    TEST_ASSERT_EQUAL_UINT32(START_INTERVAL, controller.interval());
+}
+
+void test_recovers_faster_than_reference(void)
+{
+    Controller controller(LINK_RATE_SLOWEST_INTERVAL);
+    ReferenceController reference(LINK_RATE_SLOWEST_INTERVAL);
+
+    uint32_t controllerMs = recoveryTimeMs(controller);
+    uint32_t referenceMs = recoveryTimeMs(reference);
+
+    char message[96];
+    snprintf(message, sizeof(message), "Recovery from %u ms to %u ms: %u ms, former controller %u ms",
+             LINK_RATE_SLOWEST_INTERVAL, LINK_RATE_FASTEST_INTERVAL, controllerMs, referenceMs);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, controllerMs);
+    TEST_ASSERT_LESS_THAN_UINT32(referenceMs / 2, controllerMs);
+}
+
+void test_occasional_loss_still_reaches_fastest_rate(void)
+{
+    Controller controller(LINK_RATE_SLOWEST_INTERVAL);
+    ReferenceController reference(LINK_RATE_SLOWEST_INTERVAL);
+
+    // One frame in 50 lost, the link is still good enough for the fastest rate
+    for (uint32_t i = 1; i <= 2000; i++)
+    {
+        controller.report(i % 50, CLEAN_LATENCY_US, true);
+        reference.report(i % 50, CLEAN_LATENCY_US, true);
+    }
+
+    char message[96];
+    snprintf(message, sizeof(message), "2%% loss: interval %u ms, former controller %u ms", controller.interval(),
+             reference.interval());
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(LINK_RATE_FASTEST_INTERVAL, controller.interval());
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_single_loss_keeps_the_interval);
+    RUN_TEST(test_lossy_window_backs_off);
+    RUN_TEST(test_failure_burst_backs_off_at_once);
+    RUN_TEST(test_keepalive_failures_are_ignored);
+    RUN_TEST(test_keepalives_do_not_speed_up);
+    RUN_TEST(test_high_latency_blocks_speed_up);
+    RUN_TEST(test_recovers_faster_than_reference);
+    RUN_TEST(test_occasional_loss_still_reaches_fastest_rate);
+    return UNITY_END();
+}
@@ -0,0 +1,367 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * Lever-to-air latency on a saturated link in simulated time: the former direct send with the 1 s
+ * back-off after NO_MEM compared with the newest-value mailbox keeping one frame in flight, with late
+ * and lost send callbacks injected.
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include <stdio.h>
+#include <unity.h>
+
+#include "constants.h"
+#include "send_tracker.h"
+
+// Step of the simulated time in microseconds
+#define SIM_STEP_US 100
+// Simulated time of one run in microseconds
+#define SIM_DURATION_US (20 * 1000 * 1000UL)
+// The levers post new data with every ADC frame
+#define POST_INTERVAL_US (ADC_FRAME_INTERVAL_MS * 1000)
+// Air time of one frame, longer than the post interval, so the link is saturated
+#define AIR_TIME_US 12000
+// Frames the transport buffers before it rejects new ones (NO_MEM or TRANSPORT_BUSY)
+#define TRANSPORT_QUEUE_FRAMES 6
+// Every LATE_CALLBACK_EVERY-th send callback comes LATE_CALLBACK_US after the frame left the air
+#define LATE_CALLBACK_EVERY 37
+#define LATE_CALLBACK_US    80000
+// Every LOST_CALLBACK_EVERY-th send callback doesn't come at all
+#define LOST_CALLBACK_EVERY 211
+
+// Values of the radio task and of the former sending function
+#define RADIO_SEND_TIMEOUT_US (50 * 1000UL)
+#define RADIO_BUSY_RETRY_US   2000
+#define NO_MEM_RETRY_US       (1000 * 1000UL)
+
+// Longest time the Excavator may see the same lever data with one frame in flight: the timeout of a
+// frame with a late callback, the air time of the next frame and the post interval
+#define MAILBOX_MAX_STALENESS_US (RADIO_SEND_TIMEOUT_US + 2 * AIR_TIME_US + POST_INTERVAL_US)
+
+enum SendPolicy
+{
+    POLICY_FORMER,            // Sent on every post, 1 s pause after NO_MEM
+    POLICY_MAILBOX_UNGUARDED, // One frame in flight, any send callback completes it
+    POLICY_MAILBOX,           // One frame in flight, late send callbacks ignored by SendTracker
+    SEND_POLICIES_COUNT
+};
+
+const char *const policyNames[SEND_POLICIES_COUNT] = {"former", "mailbox unguarded", "mailbox"};
+
+// Frame in the transport queue
+struct QueuedFrame
+{
+    uint32_t id;
+    uint32_t sampleUs; // Time the lever data of the frame was sampled
+};
+
+// Send callback waiting to be delivered
+struct PendingCallback
+{
+    uint32_t id;
+    uint32_t dueUs;
+};
+
+// Results of one run
+struct LinkResult
+{
+    uint32_t framesOnAir;
+    uint32_t busyRejects;
+    uint32_t timeouts;
+    uint32_t staleCompletions;
+    uint32_t wrongCompletions; // Completions taken for a frame other than the frame in flight
+    uint32_t maxInFlight;      // Most frames handed to the transport without a completion taken
+    uint64_t totalLatencyUs;   // Sum of the lever-to-air latencies of the frames on air
+    uint32_t maxLatencyUs;     // Longest time from sampling to the end of the air time
+    uint32_t maxStalenessUs;   // Longest time the Excavator kept the same lever data
+};
+
+/**
+ * @brief Simulated transport with a frame queue, a fixed air time and injected callback faults.
+ */
+class SimulatedTransport
+{
+private:
+    QueuedFrame queue[TRANSPORT_QUEUE_FRAMES];
+    uint8_t queued = 0;
+    uint32_t airEndUs = 0;
+    PendingCallback callbacks[64];
+    uint8_t callbackCount = 0;
+    uint32_t airedFrames = 0;
+    uint32_t lastAirSampleUs = 0;
+
+public:
+    LinkResult *result = nullptr;
+
+    bool send(const QueuedFrame &frame, uint32_t nowUs)
+    {
+        if (queued == TRANSPORT_QUEUE_FRAMES)
+            return false;
+        if (!queued)
+            airEndUs = nowUs + AIR_TIME_US;
+        queue[queued++] = frame;
+        return true;
+    }
+
+    /**
+     * @brief Finishes the frame on air when its air time is over and schedules its send callback.
+     */
+    void step(uint32_t nowUs)
+    {
+        if (!queued || nowUs < airEndUs)
+            return;
+
+        const QueuedFrame &frame = queue[0];
+        uint32_t latencyUs = nowUs - frame.sampleUs;
+        result->framesOnAir++;
+        result->totalLatencyUs += latencyUs;
+        result->maxLatencyUs = latencyUs > result->maxLatencyUs ? latencyUs : result->maxLatencyUs;
+        uint32_t stalenessUs = nowUs - lastAirSampleUs;
+        result->maxStalenessUs = stalenessUs > result->maxStalenessUs ? stalenessUs : result->maxStalenessUs;
+        lastAirSampleUs = frame.sampleUs;
+
+        airedFrames++;
+        if (airedFrames % LOST_CALLBACK_EVERY)
+        {
+            uint32_t delayUs = airedFrames % LATE_CALLBACK_EVERY ? 0 : LATE_CALLBACK_US;
+            callbacks[callbackCount++] = {frame.id, nowUs + delayUs};
+        }
+
+        for (uint8_t i = 1; i < queued; i++)
+            queue[i - 1] = queue[i];
+        queued--;
+        airEndUs = nowUs + AIR_TIME_US;
+    }
+
+    /**
+     * @brief Takes the oldest send callback that is due, callbacks come in the order of the frames.
+     */
+    bool takeCallback(uint32_t nowUs, uint32_t &id)
+    {
+        if (!callbackCount || nowUs < callbacks[0].dueUs)
+            return false;
+
+        id = callbacks[0].id;
+        for (uint8_t i = 1; i < callbackCount; i++)
+            callbacks[i - 1] = callbacks[i];
+        callbackCount--;
+        return true;
+    }
+};
+
+/**
+ * @brief Runs the saturated link for SIM_DURATION_US with the send policy.
+ */
+static LinkResult runLink(SendPolicy policy)
+{
+    LinkResult result = {};
+    SimulatedTransport transport;
+    SendTracker tracker;
+    transport.result = &result;
+
+    bool pending = false;         // Mailbox holds data not sent yet
+    uint32_t pendingSampleUs = 0; // Sampling time of the mailbox data
+    uint32_t nextId = 1;
+    uint32_t inFlightId = 0;
+    bool inFlight = false; // Frame in flight of the unguarded mailbox
+    uint32_t inFlightSentUs = 0;
+    uint32_t retryUs = 0; // No send before this time (busy retry or the former NO_MEM pause)
+    uint32_t sentFrames = 0, completedFrames = 0;
+
+    for (uint32_t now = 0; now < SIM_DURATION_US; now += SIM_STEP_US)
+    {
+        transport.step(now);
+
+        uint32_t callbackId;
+        while (transport.takeCallback(now, callbackId))
+        {
+            completedFrames++;
+            if (policy == POLICY_MAILBOX_UNGUARDED)
+            {
+                if (inFlight && callbackId != inFlightId)
+                    result.wrongCompletions++;
+                inFlight = false;
+            }
+            else if (policy == POLICY_MAILBOX)
+            {
+                bool delivered;
+                uint32_t doneUs;
+                tracker.complete(true, now);
+                if (tracker.takeCompletion(delivered, doneUs) && callbackId != inFlightId)
+                    result.wrongCompletions++;
+            }
+        }
+
+        if (policy == POLICY_MAILBOX_UNGUARDED && inFlight && now - inFlightSentUs >= RADIO_SEND_TIMEOUT_US)
+        {
+            inFlight = false;
+            result.timeouts++;
+        }
+        if (policy == POLICY_MAILBOX && tracker.checkTimeout(now, RADIO_SEND_TIMEOUT_US))
+            result.timeouts++;
+
+        // The levers post the newest data
+        bool posted = now % POST_INTERVAL_US == 0;
+        if (posted)
+        {
+            pending = true;
+            pendingSampleUs = now;
+        }
+
+        bool canSend = policy == POLICY_FORMER   ? posted
+                       : policy == POLICY_MAILBOX ? !tracker.isInFlight()
+                                                  : !inFlight;
+        if (!pending || !canSend || now < retryUs)
+            continue;
+
+        if (!transport.send({nextId, pendingSampleUs}, now))
+        {
+            result.busyRejects++;
+            retryUs = now + (policy == POLICY_FORMER ? NO_MEM_RETRY_US : RADIO_BUSY_RETRY_US);
+            continue;
+        }
+
+        inFlightId = nextId++;
+        pending = false;
+        sentFrames++;
+        inFlight = true;
+        inFlightSentUs = now;
+        if (policy == POLICY_MAILBOX)
+            tracker.frameSent(now);
+
+        uint32_t outstanding = sentFrames - completedFrames;
+        result.maxInFlight = outstanding > result.maxInFlight ? outstanding : result.maxInFlight;
+    }
+
+    result.staleCompletions = tracker.staleCount();
+    return result;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_report_lever_to_air(void)
+{
+    for (uint8_t policy = 0; policy < SEND_POLICIES_COUNT; policy++)
+    {
+        LinkResult result = runLink((SendPolicy)policy);
+
+        char message[200];
+        snprintf(message, sizeof(message),
+                 "%-17s: %5u frames on air, latency avg %6.1f ms max %7.1f ms, staleness max %7.1f ms, "
+                 "%u rejects, %u timeouts, %u late ignored, %u wrong completions",
+                 policyNames[policy], result.framesOnAir,
+                 result.framesOnAir ? result.totalLatencyUs / 1000.0 / result.framesOnAir : 0.0,
+                 result.maxLatencyUs / 1000.0, result.maxStalenessUs / 1000.0, result.busyRejects, result.timeouts,
+                 result.staleCompletions, result.wrongCompletions);
+        TEST_MESSAGE(message);
+
+        TEST_ASSERT_GREATER_THAN_UINT32(0, result.framesOnAir);
+    }
+}
+
+void test_mailbox_bounds_the_staleness(void)
+{
+    LinkResult former = runLink(POLICY_FORMER);
+    LinkResult mailbox = runLink(POLICY_MAILBOX);
+
+    // The former pause after NO_MEM left the Excavator without new data for a second
+    TEST_ASSERT_GREATER_THAN_UINT32(NO_MEM_RETRY_US / 2, former.maxStalenessUs);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAILBOX_MAX_STALENESS_US, mailbox.maxStalenessUs);
+    TEST_ASSERT_LESS_THAN_UINT32(former.maxLatencyUs, mailbox.maxLatencyUs);
+}
+
+void test_late_callbacks_complete_no_other_frame(void)
+{
+    LinkResult unguarded = runLink(POLICY_MAILBOX_UNGUARDED);
+    LinkResult mailbox = runLink(POLICY_MAILBOX);
+
+    // Without the tracker a late callback ends the next frame, two frames end up in flight
+    TEST_ASSERT_GREATER_THAN_UINT32(0, unguarded.wrongCompletions);
+    TEST_ASSERT_GREATER_THAN_UINT32(1, unguarded.maxInFlight);
+
+    TEST_ASSERT_EQUAL_UINT32(0, mailbox.wrongCompletions);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, mailbox.staleCompletions);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, mailbox.timeouts);
+}
+
+void test_tracker_ignores_late_completion(void)
+{
+    SendTracker tracker;
+    bool delivered;
+    uint32_t doneUs;
+
+    tracker.frameSent(0);
+    TEST_ASSERT_TRUE(tracker.checkTimeout(RADIO_SEND_TIMEOUT_US, RADIO_SEND_TIMEOUT_US));
+    tracker.frameSent(RADIO_SEND_TIMEOUT_US);
+
+    // The callback of the timed out frame must not complete the new one
+    tracker.complete(true, RADIO_SEND_TIMEOUT_US + 1000);
+    TEST_ASSERT_FALSE(tracker.takeCompletion(delivered, doneUs));
+    TEST_ASSERT_TRUE(tracker.isInFlight());
+
+    tracker.complete(false, RADIO_SEND_TIMEOUT_US + 2000);
+    TEST_ASSERT_TRUE(tracker.takeCompletion(delivered, doneUs));
+    TEST_ASSERT_FALSE(delivered);
+    TEST_ASSERT_EQUAL_UINT32(RADIO_SEND_TIMEOUT_US + 2000, doneUs);
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.staleCount());
+}
+
+void test_tracker_resyncs_after_lost_completion(void)
+{
+    SendTracker tracker;
+    bool delivered;
+    uint32_t doneUs;
+    uint32_t now = 0;
+
+    // The callback of the first frame never comes
+    tracker.frameSent(now);
+    now += RADIO_SEND_TIMEOUT_US;
+    TEST_ASSERT_TRUE(tracker.checkTimeout(now, RADIO_SEND_TIMEOUT_US));
+
+    // The following callbacks look late until the missing one is written off
+    for (uint8_t i = 0; i < SEND_TRACKER_RESYNC_TIMEOUTS; i++)
+    {
+        tracker.frameSent(now);
+        tracker.complete(true, now + 1000);
+        TEST_ASSERT_FALSE(tracker.takeCompletion(delivered, doneUs));
+        now += RADIO_SEND_TIMEOUT_US;
+        TEST_ASSERT_TRUE(tracker.checkTimeout(now, RADIO_SEND_TIMEOUT_US));
+    }
+
+    tracker.frameSent(now);
+    tracker.complete(true, now + 1000);
+    TEST_ASSERT_TRUE(tracker.takeCompletion(delivered, doneUs));
+    TEST_ASSERT_FALSE(tracker.checkTimeout(now + RADIO_SEND_TIMEOUT_US, RADIO_SEND_TIMEOUT_US));
+}
+
+void test_tracker_remaining_time(void)
+{
+    SendTracker tracker;
+
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.remainingUs(0, RADIO_SEND_TIMEOUT_US));
+    tracker.frameSent(1000);
+    TEST_ASSERT_EQUAL_UINT32(RADIO_SEND_TIMEOUT_US - 500, tracker.remainingUs(1500, RADIO_SEND_TIMEOUT_US));
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.remainingUs(1000 + RADIO_SEND_TIMEOUT_US, RADIO_SEND_TIMEOUT_US));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_report_lever_to_air);
+    RUN_TEST(test_mailbox_bounds_the_staleness);
+    RUN_TEST(test_late_callbacks_complete_no_other_frame);
+    RUN_TEST(test_tracker_ignores_late_completion);
+    RUN_TEST(test_tracker_resyncs_after_lost_completion);
+    RUN_TEST(test_tracker_remaining_time);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * Screens rendered into an off-screen GFXcanvas1 from the prerendered background compared with the
+ * former full redraw with Arduino Strings and getTextBounds(): the pixels must be equal and the time
+ * per frame of both is reported. Runs on the board (pio test -e esp32dev), the Adafruit GFX library
+ * does not build for the development machine.
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <unity.h>
+
+#include "display_screens.h"
+
+// Number of frames rendered by the benchmarks
+#define BENCHMARK_FRAMES 1000
+
+// Range of the battery voltages checked in millivolts
+#define CHECK_MIN_MV  (MIN_BATT_MV - 200)
+#define CHECK_MAX_MV  (MAX_BATT_MV + 200)
+#define CHECK_STEP_MV 7
+
+static GFXcanvas1 canvas(SCREEN_WIDTH, SCREEN_HEIGHT);
+static GFXcanvas1 reference(SCREEN_WIDTH, SCREEN_HEIGHT);
+static uint8_t background[SCREEN_BUFFER_SIZE];
+
+/**
+ * @brief The former printTitle(): clears the canvas and draws the whole default screen.
+ */
+static void referenceTitle(Adafruit_GFX &display, const char *title, uint16_t batteryVoltage, uint16_t uptimeSec)
+{
+    display.fillScreen(SSD1306_BLACK);
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println(title);
+
+    uint8_t batteryLevel = batteryCurveLevel(batteryVoltage);
+
+    // Draw the battery outline, pole and level
+    int batteryIconX = display.width() - BATTERY_ICON_WIDTH - BATTERY_POLE_WIDTH;
+    display.drawRect(batteryIconX, 0, BATTERY_ICON_WIDTH, BATTERY_ICON_HEIGHT, SSD1306_WHITE);
+    display.fillRect(batteryIconX + BATTERY_ICON_WIDTH, BATTERY_ICON_HEIGHT / 2 - BATTERY_POLE_HEIGHT / 2,
+                     BATTERY_POLE_WIDTH, BATTERY_POLE_HEIGHT, SSD1306_WHITE);
+    int batteryLevelWidth = (BATTERY_ICON_WIDTH - 2) * (batteryLevel / 100.0);
+    display.fillRect(batteryIconX + 1, 1, batteryLevelWidth, BATTERY_ICON_HEIGHT - 2, SSD1306_WHITE);
+
+    // Print the battery percentage with right-alignment
+    String batteryPercentageText = String(batteryLevel) + "%";
+    int16_t x1, y1;
+    uint16_t textWidth, textHeight;
+    display.getTextBounds(batteryPercentageText, 0, 0, &x1, &y1, &textWidth, &textHeight);
+    display.setCursor(batteryIconX - textWidth - 3, 0);
+    display.print(batteryPercentageText);
+
+    display.setCursor(0, 8);
+    display.print("Uptime: ");
+    display.print(uptimeSec);
+
+    display.setCursor(0, 56);
+    display.print("Battery: ");
+    display.print(batteryVoltage / 1000.0, 3);
+    display.print("V");
+}
+
+/**
+ * @brief The former displayOtaUpdate() for one display.
+ */
+static void referenceOta(Adafruit_GFX &display, const char *title, uint16_t progress)
+{
+    display.fillScreen(SSD1306_BLACK);
+    display.setTextSize(2);
+    display.setCursor(5, 0);
+    display.print(title);
+
+    uint16_t barFillWidth = (OTA_BAR_WIDTH - 2) * ((float)progress / 100);
+    display.drawRect(OTA_BAR_X, OTA_BAR_Y, OTA_BAR_WIDTH, OTA_BAR_HEIGHT, SSD1306_WHITE);
+    display.fillRect(OTA_BAR_X + 1, OTA_BAR_Y + 1, barFillWidth, OTA_BAR_HEIGHT - 2, SSD1306_WHITE);
+
+    String progressText = String(progress) + "%";
+    int16_t x1, y1;
+    uint16_t textWidth, textHeight;
+    display.getTextBounds(progressText, 0, 0, &x1, &y1, &textWidth, &textHeight);
+    display.setCursor((display.width() - textWidth) / 2, OTA_BAR_Y + OTA_BAR_HEIGHT + 5);
+    display.print(progressText);
+}
+
+/**
+ * @brief Renders the static parts into the background, like a change of the display state does.
+ */
+template <typename Draw>
+static void renderBackground(Draw draw)
+{
+    canvas.fillScreen(SSD1306_BLACK);
+    draw(canvas);
+    memcpy(background, canvas.getBuffer(), SCREEN_BUFFER_SIZE);
+}
+
+static void restoreBackground(void)
+{
+    memcpy(canvas.getBuffer(), background, SCREEN_BUFFER_SIZE);
+}
+
+static void assertCanvasesMatch(void)
+{
+    TEST_ASSERT_EQUAL_MEMORY(reference.getBuffer(), canvas.getBuffer(), SCREEN_BUFFER_SIZE);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_default_screen_matches_former(void)
+{
+    renderBackground([](Adafruit_GFX &display) { drawTitleBackground(display, "CONTROLLER"); });
+
+    for (uint16_t voltage = CHECK_MIN_MV; voltage <= CHECK_MAX_MV; voltage += CHECK_STEP_MV)
+    {
+        uint16_t uptimeSec = (uint16_t)(voltage * 37);
+        referenceTitle(reference, "CONTROLLER", voltage, uptimeSec);
+        restoreBackground();
+        printTitleValues(canvas, voltage, uptimeSec);
+        assertCanvasesMatch();
+    }
+}
+
+void test_ota_screen_matches_former(void)
+{
+    renderBackground([](Adafruit_GFX &display) { drawOtaBackground(display, "OTA UPDATE"); });
+
+    for (uint16_t progress = 0; progress <= 100; progress++)
+    {
+        referenceOta(reference, "OTA UPDATE", progress);
+        restoreBackground();
+        printOtaValues(canvas, progress);
+        assertCanvasesMatch();
+    }
+}
+
+void test_benchmark_default_screen(void)
+{
+    renderBackground([](Adafruit_GFX &display) { drawTitleBackground(display, "CONTROLLER"); });
+
+    int64_t start = esp_timer_get_time();
+    for (uint32_t frame = 0; frame < BENCHMARK_FRAMES; frame++)
+        referenceTitle(reference, "CONTROLLER", CHECK_MIN_MV + frame, frame);
+    int64_t referenceEnd = esp_timer_get_time();
+    for (uint32_t frame = 0; frame < BENCHMARK_FRAMES; frame++)
+    {
+        restoreBackground();
+        printTitleValues(canvas, CHECK_MIN_MV + frame, frame);
+    }
+    int64_t end = esp_timer_get_time();
+
+    char message[128];
+    snprintf(message, sizeof(message), "Default screen: full redraw %.1f us, background and values %.1f us per frame",
+             (double)(referenceEnd - start) / BENCHMARK_FRAMES, (double)(end - referenceEnd) / BENCHMARK_FRAMES);
+    TEST_MESSAGE(message);
+}
+
+void setup()
+{
+    // Wait for the serial monitor of the test runner
+    delay(2000);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_default_screen_matches_former);
+    RUN_TEST(test_ota_screen_matches_former);
+    RUN_TEST(test_benchmark_default_screen);
+    UNITY_END();
+}
+
+void loop()
+{
+}
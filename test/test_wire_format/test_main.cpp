@@ -0,0 +1,275 @@
+/**
+ * @file test_main.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * Encode/decode round trip of random controller frames in all protocol versions, including the v3
+ * lever history, rejection of corrupted frames, the sequence numbering and the throughput of the v3 codec.
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <unity.h>
+
+#include "wire_format.h"
+
+// Number of random frames of the round trip
+#define ROUND_TRIP_FRAMES 200000
+// Longest time between two history samples in microseconds (shorter than the largest age step)
+#define HISTORY_STEP_MAX_US 20000
+// Number of different frames fed to the benchmark in a loop
+#define BENCHMARK_PATTERN 1024
+
+// Range of the lever positions
+#define LEVER_MIN -1023
+#define LEVER_MAX 1023
+
+static uint32_t randomState = 1;
+
+/**
+ * @brief Returns a pseudo-random number in the range of 0 to range - 1.
+ */
+static uint32_t randomNumber(uint32_t range)
+{
+    randomState = randomState * 1664525UL + 1013904223UL;
+    return (randomState >> 8) % range;
+}
+
+static int16_t randomLever(void)
+{
+    return LEVER_MIN + (int16_t)randomNumber(LEVER_MAX - LEVER_MIN + 1);
+}
+
+/**
+ * @brief Fills the data and the history with random values, the history mixes small moves and jumps.
+ */
+static uint8_t randomFrame(controller_data_struct &data, uint32_t &timestampUs, LeverSample *history)
+{
+    for (int16_t &position : data.leverPositions)
+        position = randomLever();
+    for (bool &state : data.buttonsStates)
+        state = randomNumber(2);
+    data.battery = 2000 + randomNumber(4000);
+    timestampUs = randomNumber(UINT32_MAX);
+
+    // Delta range from no movement over typical moves to full-scale jumps
+    uint8_t count = randomNumber(WIRE_V3_HISTORY_MAX + 1);
+    int32_t spread = 1 << randomNumber(WIRE_V3_DELTA_MAX_BITS);
+    const int16_t *newer = data.leverPositions;
+    uint32_t newerUs = timestampUs;
+    for (uint8_t s = 0; s < count; s++)
+    {
+        newerUs -= randomNumber(HISTORY_STEP_MAX_US + 1);
+        history[s].timestampUs = newerUs;
+        for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+        {
+            int32_t position = newer[i] + (int32_t)randomNumber(2 * spread + 1) - spread;
+            history[s].leverPositions[i] = position < LEVER_MIN ? LEVER_MIN : position > LEVER_MAX ? LEVER_MAX : position;
+        }
+        newer = history[s].leverPositions;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the battery voltage as transferred by the v2 and v3 frames.
+ */
+static uint16_t quantizedBattery(uint16_t battery)
+{
+    int32_t steps = ((int32_t)battery - WIRE_V2_BATTERY_BASE_MV) / WIRE_V2_BATTERY_STEP_MV;
+    steps = steps < 0 ? 0 : steps > (1 << WIRE_V2_BATTERY_BITS) - 1 ? (1 << WIRE_V2_BATTERY_BITS) - 1 : steps;
+    return steps * WIRE_V2_BATTERY_STEP_MV + WIRE_V2_BATTERY_BASE_MV;
+}
+
+void setUp(void)
+{
+    randomState = 1;
+}
+
+void tearDown(void)
+{
+    setPeerProtocolVersion(WIRE_PROTOCOL_LEGACY);
+}
+
+void test_round_trip_all_versions(void)
+{
+    uint8_t buffer[WIRE_FRAME_MAX_SIZE];
+    LeverSample history[WIRE_V3_HISTORY_MAX];
+    LeverSample decodedHistory[WIRE_V3_HISTORY_MAX];
+    int16_t lastSequence = -1; // Sequence numbers are shared by the v2 and v3 frames
+    uint64_t v3Bytes = 0, v3Frames = 0;
+
+    for (uint32_t n = 0; n < ROUND_TRIP_FRAMES; n++)
+    {
+        controller_data_struct data = {}, decoded = {};
+        WireHeader header, decodedHeader;
+        uint32_t timestampUs;
+        uint8_t count = randomFrame(data, timestampUs, history);
+        uint8_t flags = randomNumber(1 << WIRE_V2_FLAGS_BITS);
+        uint8_t decodedCount = 0xFF;
+
+        setPeerProtocolVersion(WIRE_PROTOCOL_LEGACY + n % WIRE_PROTOCOL_LATEST);
+        size_t length = encodeControllerFrame(data, flags, buffer, header, timestampUs, history, count);
+        controllerFrameSent(header);
+
+        TEST_ASSERT_LESS_OR_EQUAL(WIRE_FRAME_MAX_SIZE, length);
+        TEST_ASSERT_TRUE(decodeControllerFrame(buffer, length, decoded, decodedHeader, decodedHistory, &decodedCount));
+        TEST_ASSERT_EQUAL_UINT8(getProtocolVersion(), decodedHeader.version);
+        TEST_ASSERT_EQUAL_MEMORY(data.leverPositions, decoded.leverPositions, sizeof(data.leverPositions));
+        TEST_ASSERT_EQUAL_MEMORY(data.buttonsStates, decoded.buttonsStates, sizeof(data.buttonsStates));
+
+        if (decodedHeader.version == WIRE_PROTOCOL_LEGACY)
+        {
+            TEST_ASSERT_EQUAL_UINT16(data.battery, decoded.battery);
+            TEST_ASSERT_EQUAL_UINT8(0, decodedCount);
+            continue;
+        }
+
+        TEST_ASSERT_EQUAL_UINT16(quantizedBattery(data.battery), decoded.battery);
+        TEST_ASSERT_EQUAL_UINT8(flags, decodedHeader.flags);
+        TEST_ASSERT_EQUAL_UINT8(header.sequence, decodedHeader.sequence);
+        if (lastSequence >= 0)
+            TEST_ASSERT_EQUAL_UINT8((uint8_t)(lastSequence + 1), decodedHeader.sequence);
+        lastSequence = decodedHeader.sequence;
+
+        if (decodedHeader.version == WIRE_PROTOCOL_V2)
+        {
+            TEST_ASSERT_EQUAL_UINT32(WIRE_V2_FRAME_SIZE, length);
+            TEST_ASSERT_EQUAL_UINT8(0, decodedCount);
+            continue;
+        }
+
+        // The history keeps the exact positions, the ages are rounded to the age unit without accumulating
+        TEST_ASSERT_NOT_EQUAL(sizeof(controller_data_struct), length);
+        TEST_ASSERT_EQUAL_UINT8(count, decodedCount);
+        for (uint8_t s = 0; s < count; s++)
+        {
+            TEST_ASSERT_EQUAL_MEMORY(history[s].leverPositions, decodedHistory[s].leverPositions,
+                                     sizeof(history[s].leverPositions));
+            uint32_t ageUs = timestampUs - history[s].timestampUs;
+            uint32_t decodedAgeUs = 0 - decodedHistory[s].timestampUs;
+            TEST_ASSERT_INT_WITHIN(WIRE_V3_SAMPLE_AGE_UNIT_US / 2, ageUs, decodedAgeUs);
+        }
+
+        v3Bytes += length;
+        v3Frames++;
+    }
+
+    char message[96];
+    snprintf(message, sizeof(message), "%u frames, v3 average %.1f bytes (v2 %u bytes, legacy %u bytes)",
+             ROUND_TRIP_FRAMES, (double)v3Bytes / v3Frames, (unsigned)WIRE_V2_FRAME_SIZE,
+             (unsigned)sizeof(controller_data_struct));
+    TEST_MESSAGE(message);
+}
+
+void test_corrupted_frames_are_rejected(void)
+{
+    uint8_t buffer[WIRE_FRAME_MAX_SIZE];
+    LeverSample history[WIRE_V3_HISTORY_MAX];
+
+    for (uint32_t n = 0; n < ROUND_TRIP_FRAMES / 10; n++)
+    {
+        controller_data_struct data = {}, decoded;
+        WireHeader header;
+        uint32_t timestampUs;
+        uint8_t count = randomFrame(data, timestampUs, history);
+
+        setPeerProtocolVersion(n % 2 ? WIRE_PROTOCOL_V2 : WIRE_PROTOCOL_V3);
+        size_t length = encodeControllerFrame(data, 0, buffer, header, timestampUs, history, count);
+
+        // The CRC detects every single bit error
+        uint32_t bit = randomNumber(length * 8);
+        buffer[bit / 8] ^= 1 << (bit % 8);
+        TEST_ASSERT_FALSE(decodeControllerFrame(buffer, length, decoded, header));
+        buffer[bit / 8] ^= 1 << (bit % 8);
+
+        // A truncated frame is never taken for a valid one
+        TEST_ASSERT_FALSE(decodeControllerFrame(buffer, length - 1, decoded, header) &&
+                          length - 1 != sizeof(controller_data_struct));
+    }
+}
+
+void test_sequence_advances_when_sent(void)
+{
+    uint8_t buffer[WIRE_FRAME_MAX_SIZE];
+    controller_data_struct data = {};
+    WireHeader first, retry, next;
+
+    setPeerProtocolVersion(WIRE_PROTOCOL_LATEST);
+
+    // A frame encoded again after a busy transport keeps its sequence number
+    encodeControllerFrame(data, 0, buffer, first);
+    encodeControllerFrame(data, 0, buffer, retry);
+    TEST_ASSERT_EQUAL_UINT8(first.sequence, retry.sequence);
+
+    // Sending the same frame twice consumes a single sequence number
+    controllerFrameSent(retry);
+    controllerFrameSent(retry);
+    encodeControllerFrame(data, 0, buffer, next);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(first.sequence + 1), next.sequence);
+
+    // The legacy frames carry no sequence number
+    setPeerProtocolVersion(WIRE_PROTOCOL_LEGACY);
+    encodeControllerFrame(data, 0, buffer, first);
+    controllerFrameSent(first);
+    setPeerProtocolVersion(WIRE_PROTOCOL_LATEST);
+    encodeControllerFrame(data, 0, buffer, retry);
+    TEST_ASSERT_EQUAL_UINT8(next.sequence, retry.sequence);
+}
+
+void test_benchmark_v3_codec(void)
+{
+    static uint8_t frames[BENCHMARK_PATTERN][WIRE_V3_FRAME_MAX_SIZE];
+    static size_t lengths[BENCHMARK_PATTERN];
+    static controller_data_struct data[BENCHMARK_PATTERN];
+    static LeverSample history[BENCHMARK_PATTERN][WIRE_V3_HISTORY_MAX];
+    static uint32_t timestamps[BENCHMARK_PATTERN];
+    static uint8_t counts[BENCHMARK_PATTERN];
+    volatile uint32_t sink = 0;
+
+    for (uint32_t i = 0; i < BENCHMARK_PATTERN; i++)
+    {
+        data[i] = {};
+        counts[i] = randomFrame(data[i], timestamps[i], history[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < ROUND_TRIP_FRAMES; n++)
+    {
+        uint32_t i = n % BENCHMARK_PATTERN;
+        lengths[i] = encodeControllerFrameV3(data[i], timestamps[i], {WIRE_PROTOCOL_V3, 0, (uint8_t)n}, history[i],
+                                             counts[i], frames[i]);
+        sink = sink + lengths[i];
+    }
+    auto encodeEnd = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < ROUND_TRIP_FRAMES; n++)
+    {
+        uint32_t i = n % BENCHMARK_PATTERN;
+        controller_data_struct decoded;
+        WireHeader header;
+        LeverSample decodedHistory[WIRE_V3_HISTORY_MAX];
+        uint8_t count;
+        sink = sink + decodeControllerFrame(frames[i], lengths[i], decoded, header, decodedHistory, &count);
+    }
+    auto decodeEnd = std::chrono::steady_clock::now();
+
+    double encodeNs = std::chrono::duration<double, std::nano>(encodeEnd - start).count() / ROUND_TRIP_FRAMES;
+    double decodeNs = std::chrono::duration<double, std::nano>(decodeEnd - encodeEnd).count() / ROUND_TRIP_FRAMES;
+    char message[96];
+    snprintf(message, sizeof(message), "v3 codec: encode %.1f ns, decode %.1f ns per frame", encodeNs, decodeNs);
+    TEST_MESSAGE(message);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_all_versions);
+    RUN_TEST(test_corrupted_frames_are_rejected);
+    RUN_TEST(test_sequence_advances_when_sent);
+    RUN_TEST(test_benchmark_v3_codec);
+    return UNITY_END();
+}
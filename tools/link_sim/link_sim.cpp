@@ -0,0 +1,319 @@
+/**
+ * @file link_sim.cpp
+ * @author SenMorgan https://github.com/SenMorgan
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 Sen Morgan
+ *
+ * Host tool for link experiments over UDP with the real wire format.
+ *
+ * peer   - simulated Excavator: decodes the controller frames and echoes excavator_data_struct with the
+ *          sequence numbers, like the real Excavator does. Build the firmware with
+ *          -D UDP_PEER_HOST=\"<address of this machine>\" to connect the real Controller to it.
+ * client - simulated Controller: moves the levers of a SyntheticAdcSource, runs the ADC frames through
+ *          the LeverBank of the firmware, sends the positions with their history at a fixed rate
+ *          through UdpTransport and reports the delivery ratio and the round-trip times measured
+ *          from the echoes.
+ *
+ * Loss and delay can be injected by the peer in both directions.
+ *
+ * Build:
+ *   g++ -std=gnu++17 -O2 -Isrc -Iinclude -Itest/host tools/link_sim/link_sim.cpp src/wire_format.cpp src/udp_transport.cpp \
+ *       src/lever_control.cpp -lpthread -o link_sim
+ * Usage:
+ *   link_sim peer [--port 4210] [--protocol 3] [--loss-up %] [--loss-down %] [--delay-ms D] [--jitter-ms J]
+ *   link_sim client [--host 127.0.0.1] [--port 4210] [--rate-hz 40] [--duration-s 10]
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "data_structures.h"
+#include "lever_config.h"
+#include "lever_control.h"
+#include "synthetic_adc_source.h"
+#include "udp_transport.h"
+#include "wire_format.h"
+
+// Noise amplitude of the synthetic lever samples in ADC counts (typical for the lever potentiometers)
+#define CLIENT_ADC_NOISE 6
+
+static uint64_t nowUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static const char *argValue(int argc, char **argv, const char *name, const char *defaultValue)
+{
+    for (int i = 2; i < argc - 1; i++)
+    {
+        if (!strcmp(argv[i], name))
+            return argv[i + 1];
+    }
+    return defaultValue;
+}
+
+// Echo waiting for its injected delay to expire
+struct PendingEcho
+{
+    uint64_t dueUs;
+    sockaddr_in addr;
+    excavator_data_struct data;
+
+    bool operator>(const PendingEcho &other) const { return dueUs > other.dueUs; }
+};
+
+static int runPeer(int argc, char **argv)
+{
+    uint16_t port = atoi(argValue(argc, argv, "--port", "4210"));
+    uint8_t protocol = atoi(argValue(argc, argv, "--protocol", "3"));
+    double lossUp = atof(argValue(argc, argv, "--loss-up", "0")) / 100;
+    double lossDown = atof(argValue(argc, argv, "--loss-down", "0")) / 100;
+    uint64_t delayUs = atof(argValue(argc, argv, "--delay-ms", "0")) * 1000;
+    uint64_t jitterUs = atof(argValue(argc, argv, "--jitter-ms", "0")) * 1000;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in localAddr = {};
+    localAddr.sin_family = AF_INET;
+    localAddr.sin_port = htons(port);
+    localAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (fd < 0 || bind(fd, (sockaddr *)&localAddr, sizeof(localAddr)) < 0)
+    {
+        perror("bind");
+        return 1;
+    }
+
+    printf("Simulated Excavator on UDP port %u, protocol v%u, loss up/down %.1f/%.1f%%, delay %.1f +- %.1f ms\n",
+           port, protocol, lossUp * 100, lossDown * 100, delayUs / 1000.0, jitterUs / 1000.0);
+
+    std::mt19937 rng(nowUs());
+    std::uniform_real_distribution<double> chance(0, 1);
+    std::priority_queue<PendingEcho, std::vector<PendingEcho>, std::greater<PendingEcho>> pending;
+
+    uint64_t startUs = nowUs(), lastReportUs = startUs;
+    uint32_t received = 0, invalid = 0, droppedUp = 0, droppedDown = 0, gaps = 0, historySamples = 0;
+    int lastSequence = -1;
+
+    for (;;)
+    {
+        // Wait for the next frame or the next delayed echo
+        uint64_t now = nowUs();
+        int timeoutMs = pending.empty() ? 1000 : (int)((std::max(pending.top().dueUs, now) - now + 999) / 1000);
+        pollfd pfd = {fd, POLLIN, 0};
+
+        if (poll(&pfd, 1, timeoutMs) > 0)
+        {
+            uint8_t buffer[256];
+            sockaddr_in from = {};
+            socklen_t fromLen = sizeof(from);
+            ssize_t len = recvfrom(fd, buffer, sizeof(buffer), 0, (sockaddr *)&from, &fromLen);
+            uint64_t receivedUs = nowUs();
+
+            controller_data_struct data;
+            WireHeader header;
+            LeverSample history[WIRE_V3_HISTORY_MAX];
+            uint8_t historyCount = 0;
+
+            if (len <= 0 || !decodeControllerFrame(buffer, len, data, header, history, &historyCount))
+            {
+                invalid++;
+            }
+            else if (chance(rng) < lossUp)
+            {
+                droppedUp++;
+            }
+            else
+            {
+                received++;
+                historySamples += historyCount;
+                if (header.version >= WIRE_PROTOCOL_V2)
+                {
+                    if (lastSequence >= 0 && header.sequence != (uint8_t)(lastSequence + 1))
+                        gaps += (uint8_t)(header.sequence - lastSequence - 1);
+                    lastSequence = header.sequence;
+                }
+
+                if (chance(rng) < lossDown)
+                {
+                    droppedDown++;
+                }
+                else
+                {
+                    PendingEcho echo = {};
+                    echo.addr = from;
+                    echo.dueUs = receivedUs + delayUs + (jitterUs ? rng() % (2 * jitterUs + 1) : 0) -
+                                 std::min(delayUs, jitterUs);
+                    echo.data.uptime = (receivedUs - startUs) / 1000000;
+                    echo.data.battery = 7400;
+                    echo.data.protocolVersion = protocol;
+                    echo.data.echoSequence = header.sequence;
+                    // The hold time stays zero, injected delays simulate the link and must show in the round trip
+                    pending.push(echo);
+                }
+            }
+        }
+
+        // Send the echoes whose delay has expired
+        now = nowUs();
+        while (!pending.empty() && pending.top().dueUs <= now)
+        {
+            const PendingEcho &echo = pending.top();
+            sendto(fd, &echo.data, sizeof(echo.data), 0, (const sockaddr *)&echo.addr, sizeof(echo.addr));
+            pending.pop();
+        }
+
+        if (now - lastReportUs >= 1000000)
+        {
+            printf("Received: %u | Invalid: %u | Sequence gaps: %u | Dropped up/down: %u/%u | History samples: %u\n",
+                   received, invalid, gaps, droppedUp, droppedDown, historySamples);
+            lastReportUs = now;
+        }
+    }
+}
+
+// Client state shared with the receive callback of the transport
+static std::atomic<uint32_t> echoes{0};
+static uint64_t sentTimesUs[256];
+static std::vector<uint32_t> rttsUs;
+static uint8_t peerProtocol = WIRE_PROTOCOL_LEGACY;
+
+static void onEcho([[maybe_unused]] const uint8_t *mac, const uint8_t *data, int len)
+{
+    excavator_data_struct echo = {};
+    memcpy(&echo, data, std::min<size_t>(len, sizeof(echo)));
+    setPeerProtocolVersion(echo.protocolVersion);
+    peerProtocol = echo.protocolVersion;
+
+    uint64_t sentUs = sentTimesUs[echo.echoSequence];
+    if (sentUs)
+    {
+        rttsUs.push_back(nowUs() - sentUs - echo.echoHoldUs);
+        sentTimesUs[echo.echoSequence] = 0;
+    }
+    echoes++;
+}
+
+static int runClient(int argc, char **argv)
+{
+    const char *host = argValue(argc, argv, "--host", "127.0.0.1");
+    uint16_t port = atoi(argValue(argc, argv, "--port", "4210"));
+    double rateHz = atof(argValue(argc, argv, "--rate-hz", "40"));
+    double durationS = atof(argValue(argc, argv, "--duration-s", "10"));
+
+    UdpTransport transport(host, port, 0);
+    if (!transport.begin(nullptr, onEcho))
+        return 1;
+
+    // Levers driven by synthetic ADC frames through the same filters and curves as on the Controller
+    SyntheticAdcSource adcSource;
+    LeverBank<LEVERS_COUNT, LEVER_FILTER_WINDOW> levers(leverConfigs);
+    LeverCalibration calibration;
+    uint8_t pins[LEVERS_COUNT];
+    const uint16_t center = SYNTHETIC_ADC_MAX / 2;
+
+    for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+    {
+        pins[i] = leverConfigs[i].pin;
+        calibration.center[i] = center;
+        calibration.minAdcVal[i] = leverConfigs[i].minAdcVal;
+        calibration.maxAdcVal[i] = leverConfigs[i].maxAdcVal;
+    }
+    adcSource.begin(pins, LEVERS_COUNT);
+    adcSource.setNoise(CLIENT_ADC_NOISE);
+    levers.calibrate(calibration);
+
+    // The first frame is legacy, the following ones use the version reported by the peer
+    uint64_t intervalUs = 1000000 / rateHz, startUs = nowUs();
+    uint32_t sent = 0, busy = 0;
+    uint64_t adcFrames = 0;
+    LeverSample samples[WIRE_V3_HISTORY_MAX + 1]; // Lever positions of the last ADC frames, newest first
+    uint8_t sampleCount = 0;
+
+    for (uint64_t next = startUs; next - startUs < durationS * 1000000; next += intervalUs)
+    {
+        while (nowUs() < next)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        // Sine motion on all levers, sampled every ADC_FRAME_INTERVAL_MS like the firmware does
+        uint64_t dueFrames = (next - startUs) / (ADC_FRAME_INTERVAL_MS * 1000) + 1;
+        for (; adcFrames < dueFrames; adcFrames++)
+        {
+            double frameS = (adcFrames + 1) * ADC_FRAME_INTERVAL_MS / 1000.0;
+            for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+                adcSource.setLevel(pins[i], center + center * sin(frameS * (i + 1)));
+
+            AdcFrame adcFrame = {};
+            adcSource.advance(1);
+            adcSource.readFrame(adcFrame);
+            levers.update(adcFrame);
+
+            memmove(&samples[1], &samples[0], sizeof(samples) - sizeof(samples[0]));
+            samples[0].timestampUs = adcFrame.timestampUs;
+            for (uint8_t i = 0; i < LEVERS_COUNT; i++)
+                samples[0].leverPositions[i] = levers.position(i);
+            sampleCount = std::min<uint8_t>(sampleCount + 1, WIRE_V3_HISTORY_MAX + 1);
+        }
+
+        controller_data_struct data = {};
+        memcpy(data.leverPositions, samples[0].leverPositions, sizeof(data.leverPositions));
+        data.battery = 3900;
+
+        uint8_t frame[WIRE_FRAME_MAX_SIZE];
+        WireHeader header;
+        size_t length = encodeControllerFrame(data, 0, frame, header, samples[0].timestampUs, &samples[1],
+                                              sampleCount - 1);
+        if (header.version >= WIRE_PROTOCOL_V2)
+            sentTimesUs[header.sequence] = nowUs();
+
+        if (transport.send(frame, length) == TRANSPORT_OK)
+            sent++;
+        else
+            busy++;
+    }
+
+    // Wait for the last echoes
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    transport.end();
+
+    std::sort(rttsUs.begin(), rttsUs.end());
+    printf("Sent: %u (%u rejected) | Echoes: %u (%.1f%%) | Peer protocol: v%u\n", sent, busy, echoes.load(),
+           sent ? 100.0 * echoes / sent : 0.0, peerProtocol);
+    if (!rttsUs.empty())
+    {
+        printf("RTT min: %u us | median: %u us | p99: %u us | max: %u us\n", rttsUs.front(),
+               rttsUs[rttsUs.size() / 2], rttsUs[rttsUs.size() * 99 / 100], rttsUs.back());
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    std::string mode = argc > 1 ? argv[1] : "";
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if (mode == "peer")
+        return runPeer(argc, argv);
+    if (mode == "client")
+        return runClient(argc, argv);
+
+    printf("Usage: %s peer|client [options]\n", argv[0]);
+    return 1;
+}